@@ -0,0 +1,79 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson Catch2 benchmark listener emitting CSV lines
+//===============================================================================
+
+#ifndef CPP_BASICS_BENCH_CSV_HPP_
+#define CPP_BASICS_BENCH_CSV_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_amalgamated.hpp>
+
+namespace cpp_basics {
+
+    /**
+     * Catch2 event listener printing one machine-readable CSV line per completed benchmark.
+     *
+     * Line format, prefixed with `bench-csv` to be grep'able from regular output:
+     * <pre>
+     * bench-csv,<name>,<elements>,<mean_ns>,<ns_per_element>
+     * </pre>
+     *
+     * The number of elements is taken from the trailing decimal token of the benchmark name,
+     * e.g. `hoare3 uniform 1000` processes 1000 elements.
+     * Names w/o trailing number use 1 element, i.e. ns_per_element equals mean_ns.
+     *
+     * All lines are printed in one block at the end of the test run,
+     * i.e. not interleaved with the regular reporter output.
+     */
+    class BenchCSVListener : public Catch::EventListenerBase {
+      public:
+        using Catch::EventListenerBase::EventListenerBase;
+
+        /** Returns the trailing decimal token of given benchmark name or 1 if none exists. */
+        static size_t elements(const std::string& name) noexcept {
+            const size_t p = name.find_last_not_of("0123456789");
+            if( std::string::npos == p ) {
+                return name.empty() ? 1 : std::strtoull(name.c_str(), nullptr, 10);
+            }
+            if( p + 1 == name.size() || ' ' != name[p] ) {
+                return 1;
+            }
+            const size_t n = std::strtoull(name.c_str() + p + 1, nullptr, 10);
+            return 0 < n ? n : 1;
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+            const size_t n = elements(stats.info.name);
+            const double mean_ns = stats.mean.point.count();
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), ",%zu,%.3f,%.6f", n, mean_ns, mean_ns / double(n));
+            m_lines.push_back("bench-csv,"+stats.info.name+buf);
+        }
+
+        void testRunEnded(Catch::TestRunStats const&) override {
+            if( m_lines.empty() ) {
+                return;
+            }
+            std::printf("bench-csv,name,elements,mean_ns,ns_per_element\n");
+            for(const std::string& l : m_lines) {
+                std::printf("%s\n", l.c_str());
+            }
+            std::fflush(stdout);
+        }
+
+      private:
+        std::vector<std::string> m_lines;
+    };
+
+} // namespace cpp_basics
+
+CATCH_REGISTER_LISTENER(cpp_basics::BenchCSVListener)
+
+#endif /* CPP_BASICS_BENCH_CSV_HPP_ */
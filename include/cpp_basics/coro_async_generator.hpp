@@ -0,0 +1,281 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine AsyncGenerator<T>
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_ASYNC_GENERATOR_HPP_
+#define CPP_BASICS_CORO_ASYNC_GENERATOR_HPP_
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <cpp_basics/coro_frame_pool.hpp>
+#include <cpp_basics/coro_task.hpp>
+#include <cpp_basics/coro_scheduler.hpp>
+
+namespace coro {
+
+    /**
+     * Lazy coroutine generator yielding values of type `T`, which may `co_await` in between its yields,
+     * e.g. reading a stream and yielding its parsed records without buffering the stream as a whole.
+     *
+     * Usage from a coroutine
+     * <pre>
+     *   coro::AsyncGenerator<record_t> records(coro::AsyncFd& fd) {
+     *       while( 0 < ( n = co_await fd.read_some(buf) ) ) {
+     *           ... co_yield parsed record ...
+     *       }
+     *   }
+     *
+     *   auto gen = records(fd);
+     *   while( std::optional<record_t> r = co_await gen.next() ) {
+     *       use( *r );
+     *   }
+     * </pre>
+     *
+     * By default the producer only runs while the consumer awaits next(),
+     * both handing over control via symmetric transfer, i.e. w/o synchronization and w/o growing the stack.
+     *
+     * With prefetch() enabled the producer continues on a WorkStealingScheduler after each yield
+     * to produce the next element while the consumer processes the current one,
+     * suspending only if the consumer has not taken the previous one yet, i.e. one element is prefetched.
+     * The consumer is resumed on the scheduler as well, if the producer yields to it while continuing.
+     * Hand-over state is guarded by a mutex, uncontended unless both sides meet.
+     *
+     * Awaited tasks of the producer inherit the stop token of the coroutine awaiting the first element, see this_stop_token().
+     * An exception escaping the producer is rethrown by the next() expression after all prior elements.
+     *
+     * Destructing the generator destroys the producer's frame, which, if currently prefetching,
+     * destroys itself at its next `co_yield` or completion instead.
+     *
+     * The coroutine frame is allocated via the promise's `FrameAlloc` base,
+     * pooled_frame by default, see Generator.
+     *
+     * @tparam T yielded value type
+     * @tparam FrameAlloc promise base providing the frame allocation functions
+     */
+    template <typename T, typename FrameAlloc = pooled_frame>
+    class [[nodiscard]] AsyncGenerator {
+      public:
+        struct promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct promise_type : impl::promise_base, FrameAlloc {
+            /** yielded value, taken by the consumer */
+            std::optional<T> value_;
+            /** value yielded while prefetching, moved to value_ once taken */
+            std::optional<T> next_;
+            /** consumer suspended in next() */
+            std::coroutine_handle<> consumer_;
+            /** scheduler resuming producer and consumer if prefetching, otherwise nullptr */
+            WorkStealingScheduler* sched_ = nullptr;
+            /** guards the prefetching hand-over of value_, next_, consumer_, parked_, done_ and detached_ */
+            std::mutex mtx_;
+            /** producer suspended until the consumer takes value_, or not yet started */
+            bool parked_ = true;
+            bool done_ = false;
+            /** generator destructed while prefetching, the producer destroys itself */
+            bool detached_ = false;
+            /** consumer has awaited next(), only accessed by the consumer */
+            bool started_ = false;
+
+            AsyncGenerator get_return_object() noexcept {
+                return AsyncGenerator(handle_type::from_promise(*this));
+            }
+
+            struct yield_awaiter {
+                constexpr bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+                    promise_type& p = h.promise();
+                    if( nullptr == p.sched_ ) {
+                        return p.consumer_;
+                    }
+                    WorkStealingScheduler* sched = p.sched_;
+                    std::coroutine_handle<> consumer;
+                    bool detached;
+                    {
+                        std::lock_guard<std::mutex> lock(p.mtx_);
+                        detached = p.detached_;
+                        if( !detached ) {
+                            if( p.value_ ) {
+                                p.parked_ = true;
+                                return std::noop_coroutine(); // resumed by the consumer taking value_
+                            }
+                            p.value_.swap(p.next_);
+                            consumer = std::exchange(p.consumer_, {});
+                        }
+                    }
+                    if( detached ) {
+                        h.destroy();
+                        return std::noop_coroutine();
+                    }
+                    if( consumer ) {
+                        sched->post(consumer);
+                    }
+                    return h; // continue prefetching
+                }
+                constexpr void await_resume() const noexcept { }
+            };
+
+            template <std::convertible_to<T> From>  // C++20 concept
+            yield_awaiter yield_value(From &&from) {
+                if( nullptr == sched_ ) {
+                    value_.emplace(std::forward<From>(from));
+                } else {
+                    next_.emplace(std::forward<From>(from)); // producer owned until handed over
+                }
+                return {};
+            }
+
+            struct final_awaiter {
+                constexpr bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+                    promise_type& p = h.promise();
+                    if( nullptr == p.sched_ ) {
+                        p.done_ = true;
+                        return p.consumer_;
+                    }
+                    std::coroutine_handle<> consumer;
+                    bool detached;
+                    {
+                        std::lock_guard<std::mutex> lock(p.mtx_);
+                        p.done_ = true;
+                        consumer = std::exchange(p.consumer_, {});
+                        detached = p.detached_;
+                    }
+                    if( detached ) {
+                        h.destroy();
+                        return std::noop_coroutine();
+                    }
+                    return consumer ? consumer : std::noop_coroutine();
+                }
+                constexpr void await_resume() const noexcept { }
+            };
+            final_awaiter final_suspend() noexcept { return {}; }
+
+            void return_void() noexcept { }
+        };
+
+      private:
+        handle_type h_;
+
+        struct next_awaiter {
+            handle_type h_;
+
+            bool await_ready() const noexcept {
+                const promise_type& p = h_.promise();
+                return nullptr == p.sched_ && p.done_;
+            }
+            template<typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) noexcept {
+                promise_type& p = h_.promise();
+                if constexpr ( std::derived_from<P, impl::promise_base> ) {
+                    if( !p.started_ && !p.stop_.stop_possible() ) {
+                        p.stop_ = awaiting.promise().stop_;
+                    }
+                }
+                p.started_ = true;
+                if( nullptr == p.sched_ ) {
+                    p.consumer_ = awaiting;
+                    return h_;
+                }
+                WorkStealingScheduler* sched = p.sched_;
+                bool wake;
+                {
+                    std::lock_guard<std::mutex> lock(p.mtx_);
+                    if( p.value_ || p.done_ ) {
+                        return awaiting;
+                    }
+                    p.consumer_ = awaiting;
+                    wake = std::exchange(p.parked_, false);
+                }
+                if( wake ) {
+                    sched->post(h_);
+                }
+                return std::noop_coroutine();
+            }
+            std::optional<T> await_resume() {
+                promise_type& p = h_.promise();
+                std::optional<T> res;
+                if( nullptr == p.sched_ ) {
+                    res.swap(p.value_);
+                } else {
+                    bool wake = false;
+                    {
+                        std::lock_guard<std::mutex> lock(p.mtx_);
+                        res.swap(p.value_);
+                        if( res && p.parked_ ) {
+                            p.value_.swap(p.next_);
+                            p.parked_ = false;
+                            wake = true;
+                        }
+                    }
+                    if( wake ) {
+                        p.sched_->post(h_);
+                    }
+                }
+                if( !res && p.exception_ ) {
+                    std::rethrow_exception(std::exchange(p.exception_, nullptr));
+                }
+                return res;
+            }
+        };
+
+        void release() noexcept {
+            if( !h_ ) {
+                return;
+            }
+            promise_type& p = h_.promise();
+            if( nullptr != p.sched_ ) {
+                std::lock_guard<std::mutex> lock(p.mtx_);
+                if( !p.parked_ && !p.done_ ) {
+                    p.detached_ = true;
+                    h_ = {};
+                    return;
+                }
+            }
+            std::exchange(h_, {}).destroy();
+        }
+
+      public:
+        explicit AsyncGenerator(handle_type h) noexcept : h_(h) { }
+        AsyncGenerator(AsyncGenerator &&o) noexcept : h_(std::exchange(o.h_, {})) { }
+        AsyncGenerator(const AsyncGenerator &) = delete;
+        AsyncGenerator& operator=(AsyncGenerator &&o) noexcept {
+            if( this != &o ) {
+                release();
+                h_ = std::exchange(o.h_, {});
+            }
+            return *this;
+        }
+        AsyncGenerator& operator=(const AsyncGenerator &) = delete;
+        ~AsyncGenerator() { release(); }
+
+        /**
+         * Enables prefetching the next element on the given scheduler while the consumer processes the current one.
+         *
+         * Shall be called before the first next().
+         */
+        void prefetch(WorkStealingScheduler& sched) noexcept { h_.promise().sched_ = &sched; }
+
+        /** Returns true if prefetching is enabled. */
+        bool prefetching() const noexcept { return nullptr != h_.promise().sched_; }
+
+        /**
+         * Returns an awaitable yielding the next element, or std::nullopt after the producer has completed.
+         *
+         * Resumes the producer if required and suspends the awaiting coroutine until it yields.
+         * Shall only be awaited by one coroutine at a time.
+         */
+        next_awaiter next() noexcept { return next_awaiter{h_}; }
+    };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_ASYNC_GENERATOR_HPP_ */
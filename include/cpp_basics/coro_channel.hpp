@@ -0,0 +1,408 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine bounded MPMC channel
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_CHANNEL_HPP_
+#define CPP_BASICS_CORO_CHANNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <coroutine>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include <cpp_basics/coro_scheduler.hpp>
+
+namespace coro {
+
+    /**
+     * Bounded multi-producer multi-consumer channel between coroutines with backpressure.
+     *
+     * `co_await ch.send(v)` suspends while the channel is full, `co_await ch.recv()` while it is empty,
+     * without blocking the OS thread, e.g.
+     * <pre>
+     *   coro::Task<void> producer(coro::Channel<int>& ch) {
+     *       for(int i = 0; i < 100; ++i) { co_await ch.send(i); }
+     *       ch.close();
+     *   }
+     *   coro::Task<int> consumer(coro::Channel<int>& ch) {
+     *       int sum = 0;
+     *       while( std::optional<int> v = co_await ch.recv() ) { sum += *v; }
+     *       co_return sum;
+     *   }
+     * </pre>
+     *
+     * Values pass through a lock-free ring buffer of cells tagged with a sequence number,
+     * see Dmitry Vyukov's bounded MPMC queue, hence send and receive never take a lock while neither side waits.
+     *
+     * Suspended senders and receivers are kept in FIFO waiter queues, intrusive lists of their awaiters within the coroutine frames.
+     * Only these queues are guarded by a mutex, taken on the suspension path
+     * or by the opposite side after it observed a waiter via an atomic waiter count.
+     * The waking side completes the waiter's operation on its behalf, e.g. pushes a suspended sender's value into the slot it just freed,
+     * before resuming it.
+     *
+     * Waiters are resumed on the given WorkStealingScheduler if any, otherwise inline by the waking coroutine.
+     *
+     * @tparam T value type, move constructible
+     */
+    template<typename T>
+    class Channel {
+      private:
+        constexpr static const size_t cache_line = 64;
+
+        struct cell {
+            std::atomic<size_t> seq;
+            /** constructed while `seq` marks the cell as filled */
+            union { T value; };
+
+            cell() noexcept { }
+            ~cell() { }
+        };
+
+        struct waiter {
+            waiter* next = nullptr;
+            waiter* prev = nullptr;
+            std::coroutine_handle<> handle;
+        };
+
+        /** FIFO of suspended awaiters, guarded by `mtx` */
+        struct waiter_queue {
+            std::mutex mtx;
+            waiter* head = nullptr;
+            waiter* tail = nullptr;
+            std::atomic<size_t> count = 0;
+
+            void push(waiter* w) noexcept {
+                w->next = nullptr;
+                w->prev = tail;
+                if( tail ) {
+                    tail->next = w;
+                } else {
+                    head = w;
+                }
+                tail = w;
+                count.fetch_add(1);
+            }
+            waiter* pop() noexcept {
+                waiter* w = head;
+                head = w->next;
+                if( head ) {
+                    head->prev = nullptr;
+                } else {
+                    tail = nullptr;
+                }
+                count.fetch_sub(1);
+                return w;
+            }
+            /** Removes the tail waiter, i.e. the one just pushed while still holding `mtx`. */
+            void pop_back(waiter* w) noexcept {
+                tail = w->prev;
+                if( tail ) {
+                    tail->next = nullptr;
+                } else {
+                    head = nullptr;
+                }
+                count.fetch_sub(1);
+            }
+        };
+
+        size_t m_mask;
+        std::unique_ptr<cell[]> m_cells;
+        WorkStealingScheduler* m_sched;
+        alignas(cache_line) std::atomic<size_t> m_enqueue_pos = 0;
+        alignas(cache_line) std::atomic<size_t> m_dequeue_pos = 0;
+        alignas(cache_line) std::atomic<bool> m_closed = false;
+        waiter_queue m_senders;
+        waiter_queue m_receivers;
+
+      public:
+        /**
+         * Creates a channel with a capacity of at least the given value, rounded up to a power of two.
+         * @param capacity minimum capacity, at least 2
+         * @param sched optional scheduler to resume woken waiters on, otherwise resumed inline
+         */
+        explicit Channel(size_t capacity, WorkStealingScheduler* sched = nullptr)
+        : m_mask(std::bit_ceil(std::max<size_t>(2, capacity)) - 1),
+          m_cells(new cell[m_mask + 1]), m_sched(sched)
+        {
+            for(size_t i = 0; i <= m_mask; ++i) {
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+        Channel(const Channel &) = delete;
+        Channel& operator=(const Channel &) = delete;
+
+        /** Destroys all values not received, there shall be no waiters left. */
+        ~Channel() {
+            std::optional<T> v;
+            while( pop(v) ) {
+                v.reset();
+            }
+        }
+
+        /** Returns the capacity. */
+        size_t capacity() const noexcept { return m_mask + 1; }
+
+        /** Returns the approximate number of buffered values. */
+        size_t size() const noexcept {
+            const size_t d = m_dequeue_pos.load(std::memory_order_relaxed);
+            const size_t e = m_enqueue_pos.load(std::memory_order_relaxed);
+            return e > d ? e - d : 0;
+        }
+
+        bool closed() const noexcept { return m_closed.load(); }
+
+        /**
+         * Closes the channel, failing all pending and future send() and
+         * letting recv() return `std::nullopt` once the buffered values are received.
+         *
+         * A value sent concurrently with close() may be dropped.
+         */
+        void close() {
+            m_closed.store(true);
+            waiter* senders;
+            waiter* receivers;
+            {
+                std::lock_guard<std::mutex> lock(m_senders.mtx);
+                senders = m_senders.head;
+                m_senders.head = m_senders.tail = nullptr;
+                m_senders.count.store(0);
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_receivers.mtx);
+                receivers = m_receivers.head;
+                m_receivers.head = m_receivers.tail = nullptr;
+                m_receivers.count.store(0);
+            }
+            while( senders ) {
+                waiter* w = std::exchange(senders, senders->next);
+                static_cast<send_awaiter*>(w)->m_ok = false;
+                resume(w->handle);
+            }
+            while( receivers ) {
+                waiter* w = std::exchange(receivers, receivers->next);
+                pop(static_cast<recv_awaiter*>(w)->m_value); // drain buffered values, otherwise nullopt
+                resume(w->handle);
+            }
+        }
+
+        /**
+         * Sends the given value if not full, w/o suspension.
+         * @return true if sent, otherwise `value` is left untouched
+         */
+        bool try_send(T& value) {
+            if( m_closed.load(std::memory_order_relaxed) || !push(value) ) {
+                return false;
+            }
+            notify_receiver();
+            return true;
+        }
+
+        /**
+         * Receives a value if not empty, w/o suspension.
+         * @return the value or `std::nullopt` if empty
+         */
+        std::optional<T> try_recv() {
+            std::optional<T> v;
+            if( pop(v) ) {
+                notify_sender();
+            }
+            return v;
+        }
+
+        class send_awaiter : waiter {
+          public:
+            bool await_ready() {
+                if( m_ch.closed() ) {
+                    m_ok = false;
+                    return true;
+                }
+                return m_ch.try_send(m_value);
+            }
+            bool await_suspend(std::coroutine_handle<> h) {
+                this->handle = h;
+                Channel& ch = m_ch;
+                std::unique_lock<std::mutex> lock(ch.m_senders.mtx);
+                ch.m_senders.push(this);
+                // seq_cst pairs with the receiver's notify_sender(): either we see the freed slot or it sees this waiter
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if( ch.closed() ) {
+                    ch.m_senders.pop_back(this);
+                    m_ok = false;
+                    return false;
+                }
+                if( ch.push(m_value) ) {
+                    ch.m_senders.pop_back(this);
+                    lock.unlock();
+                    ch.notify_receiver();
+                    return false;
+                }
+                return true; // may be resumed by another thread once unlocked, not touching this awaiter anymore
+            }
+            /** Returns true if sent, false if the channel has been closed. */
+            bool await_resume() const noexcept { return m_ok; }
+
+          private:
+            friend class Channel;
+            Channel& m_ch;
+            T m_value;
+            bool m_ok = true;
+
+            send_awaiter(Channel& ch, T&& value) : m_ch(ch), m_value(std::move(value)) { }
+        };
+
+        class recv_awaiter : waiter {
+          public:
+            bool await_ready() {
+                m_value = m_ch.try_recv();
+                return m_value.has_value();
+            }
+            bool await_suspend(std::coroutine_handle<> h) {
+                this->handle = h;
+                Channel& ch = m_ch;
+                std::unique_lock<std::mutex> lock(ch.m_receivers.mtx);
+                ch.m_receivers.push(this);
+                // seq_cst pairs with the sender's notify_receiver(): either we see the value or it sees this waiter
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if( ch.pop(m_value) ) {
+                    ch.m_receivers.pop_back(this);
+                    lock.unlock();
+                    ch.notify_sender();
+                    return false;
+                }
+                if( ch.closed() ) {
+                    ch.m_receivers.pop_back(this);
+                    return false;
+                }
+                return true; // may be resumed by another thread once unlocked, not touching this awaiter anymore
+            }
+            /** Returns the received value or `std::nullopt` if the channel has been closed and drained. */
+            std::optional<T> await_resume() noexcept { return std::move(m_value); }
+
+          private:
+            friend class Channel;
+            Channel& m_ch;
+            std::optional<T> m_value;
+
+            explicit recv_awaiter(Channel& ch) : m_ch(ch) { }
+        };
+
+        /**
+         * Returns an awaitable sending the given value, suspending while the channel is full.
+         * Its `co_await` result is false if the channel has been closed.
+         */
+        [[nodiscard]] send_awaiter send(T value) { return send_awaiter(*this, std::move(value)); }
+
+        /**
+         * Returns an awaitable receiving a value, suspending while the channel is empty.
+         * Its `co_await` result is `std::nullopt` if the channel has been closed and drained.
+         */
+        [[nodiscard]] recv_awaiter recv() { return recv_awaiter(*this); }
+
+      private:
+        /** Lock-free enqueue, moves from `value` on success. */
+        bool push(T& value) {
+            size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            cell* c;
+            while( true ) {
+                c = &m_cells[pos & m_mask];
+                const size_t seq = c->seq.load(std::memory_order_acquire);
+                const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+                if( 0 == diff ) {
+                    if( m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+                        break;
+                    }
+                } else if( 0 > diff ) {
+                    return false; // full
+                } else {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            ::new (&c->value) T(std::move(value));
+            c->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Lock-free dequeue into `out`. */
+        bool pop(std::optional<T>& out) {
+            size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            cell* c;
+            while( true ) {
+                c = &m_cells[pos & m_mask];
+                const size_t seq = c->seq.load(std::memory_order_acquire);
+                const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+                if( 0 == diff ) {
+                    if( m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+                        break;
+                    }
+                } else if( 0 > diff ) {
+                    return false; // empty
+                } else {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            out.emplace(std::move(c->value));
+            c->value.~T();
+            c->seq.store(pos + m_mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        void resume(std::coroutine_handle<> h) {
+            if( m_sched ) {
+                m_sched->post(h);
+            } else {
+                h.resume();
+            }
+        }
+
+        /** After a slot has been freed, pushes the first suspended sender's value and resumes it. */
+        void notify_sender() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( 0 == m_senders.count.load(std::memory_order_relaxed) ) {
+                return;
+            }
+            send_awaiter* w = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_senders.mtx);
+                if( m_senders.head && push(static_cast<send_awaiter*>(m_senders.head)->m_value) ) {
+                    w = static_cast<send_awaiter*>(m_senders.pop());
+                } // else slot taken by another sender, waiter stays first
+            }
+            if( w ) {
+                notify_receiver();
+                resume(w->handle);
+            }
+        }
+
+        /** After a value has been pushed, pops it for the first suspended receiver and resumes it. */
+        void notify_receiver() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( 0 == m_receivers.count.load(std::memory_order_relaxed) ) {
+                return;
+            }
+            recv_awaiter* w = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_receivers.mtx);
+                if( m_receivers.head && pop(static_cast<recv_awaiter*>(m_receivers.head)->m_value) ) {
+                    w = static_cast<recv_awaiter*>(m_receivers.pop());
+                } // else value taken by another receiver, waiter stays first
+            }
+            if( w ) {
+                notify_sender();
+                resume(w->handle);
+            }
+        }
+    };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_CHANNEL_HPP_ */
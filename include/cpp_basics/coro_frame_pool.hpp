@@ -0,0 +1,248 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine frame pool allocation
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_FRAME_POOL_HPP_
+#define CPP_BASICS_CORO_FRAME_POOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <type_traits>
+
+namespace coro {
+
+    /** Frame allocation statistics of one thread's FramePool. */
+    struct frame_pool_stats {
+        /** allocations served from a free list or an arena */
+        size_t hits = 0;
+        /** allocations served by the global operator new */
+        size_t misses = 0;
+        /** frames allocated minus frames deallocated on this thread */
+        ptrdiff_t live = 0;
+        /** maximum of live frames */
+        ptrdiff_t peak = 0;
+    };
+
+    class FramePool;
+
+    /**
+     * Caller-provided memory arena for coroutine frames, bump allocated with per size-class free lists.
+     *
+     * Constructing an arena installs it in the calling thread's FramePool until destructed,
+     * arenas may be nested.
+     * While installed, pooled frames are taken from the arena first and from the pool if the arena is exhausted.
+     *
+     * All frames allocated from the arena must be destroyed on the same thread before the arena.
+     */
+    class FrameArena {
+      public:
+        FrameArena(void* buffer, size_t size) noexcept;
+        FrameArena(const FrameArena &) = delete;
+        FrameArena& operator=(const FrameArena &) = delete;
+        ~FrameArena() noexcept;
+
+        /** Returns true if the given frame was allocated from this arena. */
+        bool owns(const void* p) const noexcept { return m_begin <= p && p < m_end; }
+
+        /** Returns the number of bytes bump allocated so far. */
+        size_t used() const noexcept { return size_t(m_next - m_begin); }
+
+        /** Returns the arena's size in bytes. */
+        size_t size() const noexcept { return size_t(m_end - m_begin); }
+
+      private:
+        friend class FramePool;
+
+        struct free_node { free_node* next; };
+
+        std::byte* m_begin;
+        std::byte* m_next;
+        std::byte* m_end;
+        free_node* m_free[16] = {};
+        size_t m_live = 0;
+        FrameArena* m_prev;
+
+        void* allocate(size_t cls, size_t csize) noexcept {
+            if( nullptr != m_free[cls] ) {
+                free_node* n = m_free[cls];
+                m_free[cls] = n->next;
+                ++m_live;
+                return n;
+            }
+            if( size_t(m_end - m_next) < csize ) {
+                return nullptr;
+            }
+            void* p = m_next;
+            m_next += csize;
+            ++m_live;
+            return p;
+        }
+        void deallocate(void* p, size_t cls) noexcept {
+            free_node* n = ::new(p) free_node{m_free[cls]};
+            m_free[cls] = n;
+            --m_live;
+        }
+    };
+
+    /**
+     * Thread-local size-class pool of coroutine frames.
+     *
+     * Frame sizes are rounded up to a multiple of `granularity` bytes,
+     * each of the `class_count` size classes keeps a singly linked free list of up to `max_cached` released frames.
+     * Frames larger than `max_frame_size` bypass the pool.
+     *
+     * Frames released on another thread than allocated, e.g. resumed on a scheduler,
+     * are returned to the releasing thread's pool.
+     *
+     * Used by coroutine promise types via pooled_frame.
+     */
+    class FramePool {
+      public:
+        constexpr static const size_t granularity = 64;
+        constexpr static const size_t class_count = 16;
+        constexpr static const size_t max_frame_size = granularity * class_count;
+        constexpr static const size_t max_cached = 4096;
+        static_assert(class_count == std::extent_v<decltype(FrameArena::m_free)>);
+
+        /** Returns the calling thread's pool. */
+        static FramePool& local() noexcept {
+            static thread_local FramePool pool;
+            return pool;
+        }
+
+        FramePool() noexcept = default;
+        FramePool(const FramePool &) = delete;
+        FramePool& operator=(const FramePool &) = delete;
+        ~FramePool() noexcept { trim(); }
+
+        void* allocate(size_t size) {
+            if( ++m_stats.live > m_stats.peak ) {
+                m_stats.peak = m_stats.live;
+            }
+            if( size > max_frame_size ) {
+                ++m_stats.misses;
+                return ::operator new(size);
+            }
+            const size_t cls = ( size - 1 ) / granularity;
+            const size_t csize = ( cls + 1 ) * granularity;
+            if( nullptr != m_arena ) {
+                void* p = m_arena->allocate(cls, csize);
+                if( nullptr != p ) {
+                    ++m_stats.hits;
+                    return p;
+                }
+            }
+            if( nullptr != m_free[cls] ) {
+                free_node* n = m_free[cls];
+                m_free[cls] = n->next;
+                --m_cached[cls];
+                ++m_stats.hits;
+                return n;
+            }
+            ++m_stats.misses;
+            return ::operator new(csize);
+        }
+
+        void deallocate(void* p, size_t size) noexcept {
+            --m_stats.live;
+            if( size > max_frame_size ) {
+                ::operator delete(p, size);
+                return;
+            }
+            const size_t cls = ( size - 1 ) / granularity;
+            for(FrameArena* a = m_arena; nullptr != a; a = a->m_prev) {
+                if( a->owns(p) ) {
+                    a->deallocate(p, cls);
+                    return;
+                }
+            }
+            if( m_cached[cls] < max_cached ) {
+                m_free[cls] = ::new(p) free_node{m_free[cls]};
+                ++m_cached[cls];
+            } else {
+                ::operator delete(p, ( cls + 1 ) * granularity);
+            }
+        }
+
+        /** Returns this thread's statistics. */
+        const frame_pool_stats& stats() const noexcept { return m_stats; }
+
+        /** Resets hits, misses and peak, the latter to the current number of live frames. */
+        void reset_stats() noexcept {
+            m_stats.hits = 0;
+            m_stats.misses = 0;
+            m_stats.peak = m_stats.live;
+        }
+
+        /** Returns the number of cached frames of all size classes. */
+        size_t cached() const noexcept {
+            size_t n = 0;
+            for(size_t c : m_cached) { n += c; }
+            return n;
+        }
+
+        /** Releases all cached frames to the global operator delete. */
+        void trim() noexcept {
+            for(size_t cls = 0; cls < class_count; ++cls) {
+                while( nullptr != m_free[cls] ) {
+                    free_node* n = m_free[cls];
+                    m_free[cls] = n->next;
+                    ::operator delete(static_cast<void*>(n), ( cls + 1 ) * granularity);
+                }
+                m_cached[cls] = 0;
+            }
+        }
+
+      private:
+        friend class FrameArena;
+
+        struct free_node { free_node* next; };
+
+        free_node* m_free[class_count] = {};
+        size_t m_cached[class_count] = {};
+        FrameArena* m_arena = nullptr;
+        frame_pool_stats m_stats;
+    };
+
+    inline FrameArena::FrameArena(void* buffer, size_t size) noexcept {
+        // align the bump pointer for the coroutine frame, sizes are multiples of FramePool::granularity
+        constexpr size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        const uintptr_t b = reinterpret_cast<uintptr_t>(buffer);
+        const uintptr_t a = ( b + align - 1 ) & ~uintptr_t(align - 1);
+        m_begin = static_cast<std::byte*>(buffer) + ( a - b );
+        m_next = m_begin;
+        m_end = static_cast<std::byte*>(buffer) + ( a - b <= size ? size : a - b );
+        FramePool& pool = FramePool::local();
+        m_prev = pool.m_arena;
+        pool.m_arena = this;
+    }
+
+    inline FrameArena::~FrameArena() noexcept {
+        assert( 0 == m_live ); // frames must not outlive their arena
+        FramePool& pool = FramePool::local();
+        assert( this == pool.m_arena );
+        pool.m_arena = m_prev;
+    }
+
+    /**
+     * Base of a coroutine promise_type allocating its frame from the thread-local FramePool.
+     *
+     * The coroutine frame uses the promise's class-specific allocation functions,
+     * the sized `operator delete` passes the frame size back for its size class.
+     */
+    struct pooled_frame {
+        static void* operator new(size_t size) { return FramePool::local().allocate(size); }
+        static void operator delete(void* p, size_t size) noexcept { FramePool::local().deallocate(p, size); }
+    };
+
+    /** Base of a coroutine promise_type using the global allocation functions, i.e. no pool. */
+    struct heap_frame { };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_FRAME_POOL_HPP_ */
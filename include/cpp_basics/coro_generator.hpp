@@ -0,0 +1,235 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine Generator<T>
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_GENERATOR_HPP_
+#define CPP_BASICS_CORO_GENERATOR_HPP_
+
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <ranges>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <cpp_basics/coro_frame_pool.hpp>
+
+namespace coro {
+
+    /**
+     * Wraps a generator to be yielded element-wise by an enclosing generator
+     * via `co_yield elements_of(inner)`, analog to C++23 `std::ranges::elements_of`.
+     *
+     * An lvalue generator is referenced, an rvalue generator is moved into the wrapper.
+     */
+    template<typename G>
+    struct elements_of {
+        G gen;
+
+        // not an aggregate, GCC 12 destructs aggregate temporaries of a co_yield operand twice
+        explicit elements_of(G&& g) noexcept : gen(std::forward<G>(g)) { }
+    };
+
+    template<typename G>
+    elements_of(G&&) -> elements_of<G>;
+
+    /**
+     * Lazy coroutine generator yielding values of type `T`, see lesson51_coroutine1 `test_06::Generator`.
+     *
+     * Usage
+     * <pre>
+     *   for(auto gen = counter(); gen; ) {
+     *       use( gen() );
+     *   }
+     * </pre>
+     *
+     * A generator may yield all elements of a nested generator of the same type via `co_yield elements_of(inner)`.
+     * Nested generators form a stack, where the consumer always resumes the innermost (leaf) frame directly
+     * and a completed nested generator resumes its parent via symmetric transfer.
+     * Hence each element costs one resume regardless of the nesting depth,
+     * while manually re-yielding `while( inner ) { co_yield inner(); }` costs one resume per level.
+     * An exception escaping a nested generator is rethrown from its `co_yield elements_of(..)` expression.
+     *
+     * A generator is also a single-pass std::ranges::input_range and std::ranges::view via begin() and end(),
+     * composable with standard algorithms and the lazy adaptors of coro_views.hpp:
+     * <pre>
+     *   for(unsigned v : counter() | coro::views::filter(is_even)) {
+     *       use( v );
+     *   }
+     * </pre>
+     * Consume a generator either via its iterator or via `operator bool` and `operator()`, not both.
+     *
+     * The coroutine frame is allocated via the promise's `FrameAlloc` base,
+     * pooled_frame by default, i.e. from the thread-local FramePool.
+     * Use heap_frame for the global allocation functions.
+     *
+     * @tparam T yielded value type
+     * @tparam FrameAlloc promise base providing the frame allocation functions
+     */
+    template <typename T, typename FrameAlloc = pooled_frame>
+    class [[nodiscard]] Generator : public std::ranges::view_base {
+      public:
+        struct promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct promise_type : FrameAlloc {
+            /** yielded value, only used by the root generator */
+            std::optional<T> value_;
+            std::exception_ptr exception_;
+            /** outermost generator consumed by the caller */
+            promise_type* root_ = this;
+            /** enclosing generator, if nested */
+            promise_type* parent_ = nullptr;
+            /** innermost active generator, resumed by the consumer, only used by the root generator */
+            promise_type* leaf_ = this;
+
+            Generator get_return_object() noexcept {
+                return Generator(handle_type::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            struct final_awaiter {
+                constexpr bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+                    promise_type& p = h.promise();
+                    if( nullptr == p.parent_ ) {
+                        return std::noop_coroutine(); // root completed, return to the consumer
+                    }
+                    p.root_->leaf_ = p.parent_;
+                    return handle_type::from_promise(*p.parent_);
+                }
+                constexpr void await_resume() const noexcept { }
+            };
+            final_awaiter final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+            template <std::convertible_to<T> From>  // C++20 concept
+            std::suspend_always yield_value(From &&from) {
+                root_->value_.emplace(std::forward<From>(from));
+                return {};
+            }
+
+            /** Awaiter of a nested generator, which is owned by the `elements_of` temporary living until the `co_yield` resumes. */
+            struct nested_awaiter {
+                handle_type h_;
+
+                bool await_ready() const noexcept { return !h_ || h_.done(); }
+                std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+                    promise_type& parent = h.promise();
+                    promise_type& inner = h_.promise();
+                    inner.parent_ = &parent;
+                    inner.root_ = parent.root_;
+                    parent.root_->leaf_ = &inner;
+                    return h_;
+                }
+                void await_resume() {
+                    if( h_ && h_.promise().exception_ ) {
+                        std::rethrow_exception(std::exchange(h_.promise().exception_, nullptr));
+                    }
+                }
+            };
+
+            template<typename G>
+            requires std::same_as<std::remove_cvref_t<G>, Generator>
+            nested_awaiter yield_value(elements_of<G>&& nested) noexcept {
+                return nested_awaiter{ nested.gen.h_ };
+            }
+
+            void return_void() noexcept { }
+        };
+
+        explicit Generator(handle_type h) noexcept : h_(h) { }
+        Generator(Generator &&o) noexcept : h_(std::exchange(o.h_, {})), full_(std::exchange(o.full_, false)) { }
+        Generator(const Generator &) = delete;
+        Generator& operator=(Generator &&o) noexcept {
+            if( this != &o ) {
+                if( h_ ) {
+                    h_.destroy();
+                }
+                h_ = std::exchange(o.h_, {});
+                full_ = std::exchange(o.full_, false);
+            }
+            return *this;
+        }
+        Generator& operator=(const Generator &) = delete;
+        ~Generator() {
+            if( h_ ) {
+                h_.destroy();
+            }
+        }
+
+        /** Returns true if a next value is available, resuming the coroutine if required. */
+        explicit operator bool() {
+            fill();
+            return !h_.done();
+        }
+
+        /** Returns the next value, resuming the coroutine if required. */
+        T operator()() {
+            fill();
+            full_ = false;
+            return std::move(*h_.promise().value_);
+        }
+
+        /** Single-pass input iterator, resuming the innermost generator on increment. */
+        class iterator {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::remove_cvref_t<T>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() noexcept = default;
+
+            T& operator*() const noexcept { return *h_.promise().value_; }
+            T* operator->() const noexcept { return &*h_.promise().value_; }
+
+            iterator& operator++() {
+                advance(h_);
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) noexcept { return i.h_.done(); }
+
+          private:
+            friend class Generator;
+            handle_type h_;
+
+            explicit iterator(handle_type h) noexcept : h_(h) { }
+        };
+
+        /** Resumes the coroutine up to its first value, if not yet done, and returns the iterator. */
+        iterator begin() {
+            fill();
+            return iterator(h_);
+        }
+        constexpr std::default_sentinel_t end() const noexcept { return {}; }
+
+      private:
+        handle_type h_;
+        bool full_ = false;
+
+        /** Resumes the innermost generator to yield the next value, rethrowing an escaped exception. */
+        static void advance(handle_type h) {
+            handle_type::from_promise(*h.promise().leaf_).resume();
+            if( h.promise().exception_ ) {
+                std::rethrow_exception(std::exchange(h.promise().exception_, nullptr));
+            }
+        }
+
+        void fill() {
+            if( !full_ ) {
+                full_ = true;
+                advance(h_);
+            }
+        }
+    };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_GENERATOR_HPP_ */
@@ -0,0 +1,338 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine epoll reactor with async I/O awaitables
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_REACTOR_HPP_
+#define CPP_BASICS_CORO_REACTOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <cpp_basics/coro_task.hpp>
+
+namespace coro {
+
+    class AsyncFd;
+
+    /**
+     * Single-threaded epoll event loop resuming coroutines awaiting I/O readiness of an AsyncFd.
+     *
+     * Coroutines are started via spawn() and run on the thread calling run(),
+     * suspending on `EAGAIN` until epoll reports the file descriptor's readiness.
+     * Hence one thread serves thousands of non-blocking streams.
+     *
+     * File descriptors are registered edge-triggered for both directions once, see AsyncFd,
+     * i.e. no `epoll_ctl` call per suspension.
+     *
+     * Only post() may be called from other threads, waking up the loop via an eventfd.
+     */
+    class EpollReactor {
+      public:
+        /** Maximum number of events fetched per `epoll_wait` */
+        constexpr static const int max_events = 256;
+
+        EpollReactor() {
+            m_epfd = ::epoll_create1(EPOLL_CLOEXEC);
+            if( 0 > m_epfd ) {
+                throw std::system_error(errno, std::generic_category(), "epoll_create1");
+            }
+            m_wakefd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if( 0 > m_wakefd ) {
+                const int err = errno;
+                ::close(m_epfd);
+                throw std::system_error(err, std::generic_category(), "eventfd");
+            }
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.ptr = nullptr; // wake-up
+            if( 0 != ::epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_wakefd, &ev) ) {
+                const int err = errno;
+                ::close(m_wakefd);
+                ::close(m_epfd);
+                throw std::system_error(err, std::generic_category(), "epoll_ctl");
+            }
+        }
+        EpollReactor(const EpollReactor &) = delete;
+        EpollReactor& operator=(const EpollReactor &) = delete;
+        ~EpollReactor() {
+            ::close(m_wakefd);
+            ::close(m_epfd);
+        }
+
+        /** Returns the epoll file descriptor. */
+        int native_handle() const noexcept { return m_epfd; }
+
+        /** Returns the number of spawned tasks not yet completed. */
+        size_t active() const noexcept { return m_active; }
+
+        /**
+         * Starts the given task on the next run() iteration, running detached.
+         *
+         * An exception escaping the task is rethrown by run().
+         */
+        void spawn(Task<void> task) {
+            ++m_active;
+            detached(*this, std::move(task));
+        }
+
+        /** Queues the given coroutine handle for resumption by run(), may be called from any thread. */
+        void post(std::coroutine_handle<> h) {
+            {
+                std::lock_guard<std::mutex> lock(m_posted_mtx);
+                m_posted.push_back(h);
+            }
+            const uint64_t one = 1;
+            [[maybe_unused]] const ssize_t n = ::write(m_wakefd, &one, sizeof(one));
+        }
+
+        struct schedule_awaiter {
+            EpollReactor& reactor;
+
+            constexpr bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { reactor.post(h); }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        /** Returns an awaitable resuming the awaiting coroutine on the reactor's thread. */
+        schedule_awaiter schedule() noexcept { return schedule_awaiter{*this}; }
+
+        /**
+         * Runs the event loop until all spawned tasks have completed.
+         *
+         * Rethrows the first exception escaped a spawned task, after all tasks have completed.
+         */
+        void run() {
+            epoll_event events[max_events];
+            std::vector<std::coroutine_handle<>> ready;
+            while( true ) {
+                ready.clear();
+                {
+                    std::lock_guard<std::mutex> lock(m_posted_mtx);
+                    ready.swap(m_posted);
+                }
+                for(std::coroutine_handle<> h : ready) {
+                    h.resume();
+                }
+                if( 0 == m_active ) {
+                    break;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(m_posted_mtx);
+                    if( !m_posted.empty() ) {
+                        continue;
+                    }
+                }
+                const int n = ::epoll_wait(m_epfd, events, max_events, -1);
+                if( 0 > n ) {
+                    if( EINTR == errno ) {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "epoll_wait");
+                }
+                // collect all handles first, a resumed coroutine may destroy another AsyncFd of this batch
+                ready.clear();
+                for(int i = 0; i < n; ++i) {
+                    dispatch(events[i], ready);
+                }
+                for(std::coroutine_handle<> h : ready) {
+                    h.resume();
+                }
+            }
+            if( m_exception ) {
+                std::rethrow_exception(std::exchange(m_exception, nullptr));
+            }
+        }
+
+      private:
+        friend class AsyncFd;
+
+        struct detached_task {
+            struct promise_type {
+                detached_task get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() noexcept { }
+                void unhandled_exception() noexcept { std::terminate(); } // caught within detached()
+            };
+        };
+
+        static detached_task detached(EpollReactor& reactor, Task<void> task) {
+            co_await reactor.schedule();
+            try {
+                co_await task;
+            } catch (...) {
+                if( !reactor.m_exception ) {
+                    reactor.m_exception = std::current_exception();
+                }
+            }
+            --reactor.m_active;
+        }
+
+        inline void dispatch(const epoll_event& ev, std::vector<std::coroutine_handle<>>& ready) noexcept;
+
+        int m_epfd;
+        int m_wakefd;
+        size_t m_active = 0;
+        std::exception_ptr m_exception;
+        std::mutex m_posted_mtx;
+        std::vector<std::coroutine_handle<>> m_posted;
+    };
+
+    /**
+     * Non-blocking file descriptor registered with an EpollReactor, owning the descriptor.
+     *
+     * Provides awaitables for readiness and the async operations read_some(), read() and write(),
+     * which try the system call first and only suspend on `EAGAIN`.
+     * At most one reader and one writer may await concurrently.
+     *
+     * Regular files are not supported by epoll, hence always ready, i.e. their I/O never suspends.
+     * `io_uring` would allow truly asynchronous file I/O.
+     *
+     * I/O errors are thrown as std::system_error.
+     */
+    class AsyncFd {
+      public:
+        /**
+         * Takes ownership of the given file descriptor, sets `O_NONBLOCK` and registers it with the reactor.
+         */
+        AsyncFd(EpollReactor& reactor, int fd) : m_reactor(reactor), m_fd(fd) {
+            const int flags = ::fcntl(m_fd, F_GETFL);
+            if( 0 > flags || 0 > ::fcntl(m_fd, F_SETFL, flags | O_NONBLOCK) ) {
+                throw std::system_error(errno, std::generic_category(), "fcntl");
+            }
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.ptr = this;
+            if( 0 != ::epoll_ctl(m_reactor.m_epfd, EPOLL_CTL_ADD, m_fd, &ev) ) {
+                if( EPERM != errno ) {
+                    throw std::system_error(errno, std::generic_category(), "epoll_ctl");
+                }
+                m_pollable = false; // regular file
+            }
+        }
+        AsyncFd(const AsyncFd &) = delete;
+        AsyncFd& operator=(const AsyncFd &) = delete;
+        ~AsyncFd() { close(); }
+
+        int native_handle() const noexcept { return m_fd; }
+
+        /** Returns false if the descriptor is not supported by epoll, e.g. a regular file. */
+        bool pollable() const noexcept { return m_pollable; }
+
+        /** Deregisters and closes the descriptor. */
+        void close() noexcept {
+            if( 0 <= m_fd ) {
+                if( m_pollable ) {
+                    ::epoll_ctl(m_reactor.m_epfd, EPOLL_CTL_DEL, m_fd, nullptr);
+                }
+                ::close(m_fd);
+                m_fd = -1;
+            }
+        }
+
+        struct ready_awaiter {
+            std::coroutine_handle<>* waiter;
+
+            bool await_ready() const noexcept { return nullptr == waiter; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { *waiter = h; }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        /** Returns an awaitable suspending until the descriptor reports readability, including hang-up or error. */
+        ready_awaiter readable() noexcept { return ready_awaiter{ m_pollable ? &m_reader : nullptr }; }
+
+        /** Returns an awaitable suspending until the descriptor reports writability, including hang-up or error. */
+        ready_awaiter writable() noexcept { return ready_awaiter{ m_pollable ? &m_writer : nullptr }; }
+
+        /**
+         * Reads up to `buf.size()` bytes, suspending while none are available.
+         * @return number of bytes read, zero at end of stream
+         */
+        Task<size_t> read_some(std::span<std::byte> buf) {
+            while( true ) {
+                const ssize_t n = ::read(m_fd, buf.data(), buf.size());
+                if( 0 <= n ) {
+                    co_return size_t(n);
+                }
+                if( EAGAIN == errno || EWOULDBLOCK == errno ) {
+                    co_await readable();
+                } else if( EINTR != errno ) {
+                    throw std::system_error(errno, std::generic_category(), "read");
+                }
+            }
+        }
+
+        /**
+         * Reads `buf.size()` bytes unless the end of stream is reached.
+         * @return number of bytes read, less than `buf.size()` at end of stream
+         */
+        Task<size_t> read(std::span<std::byte> buf) {
+            size_t done = 0;
+            while( done < buf.size() ) {
+                const size_t n = co_await read_some(buf.subspan(done));
+                if( 0 == n ) {
+                    break;
+                }
+                done += n;
+            }
+            co_return done;
+        }
+
+        /** Writes all of `buf`, suspending while the descriptor's buffer is full. */
+        Task<void> write(std::span<const std::byte> buf) {
+            while( !buf.empty() ) {
+                const ssize_t n = ::write(m_fd, buf.data(), buf.size());
+                if( 0 <= n ) {
+                    buf = buf.subspan(size_t(n));
+                } else if( EAGAIN == errno || EWOULDBLOCK == errno ) {
+                    co_await writable();
+                } else if( EINTR != errno ) {
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+            }
+        }
+
+      private:
+        friend class EpollReactor;
+
+        EpollReactor& m_reactor;
+        int m_fd;
+        bool m_pollable = true;
+        std::coroutine_handle<> m_reader;
+        std::coroutine_handle<> m_writer;
+    };
+
+    inline void EpollReactor::dispatch(const epoll_event& ev, std::vector<std::coroutine_handle<>>& ready) noexcept {
+        if( nullptr == ev.data.ptr ) {
+            uint64_t count;
+            [[maybe_unused]] const ssize_t n = ::read(m_wakefd, &count, sizeof(count));
+            return;
+        }
+        AsyncFd& f = *static_cast<AsyncFd*>(ev.data.ptr);
+        if( f.m_reader && 0 != ( ev.events & ( EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR ) ) ) {
+            ready.push_back(std::exchange(f.m_reader, nullptr));
+        }
+        if( f.m_writer && 0 != ( ev.events & ( EPOLLOUT | EPOLLHUP | EPOLLERR ) ) ) {
+            ready.push_back(std::exchange(f.m_writer, nullptr));
+        }
+    }
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_REACTOR_HPP_ */
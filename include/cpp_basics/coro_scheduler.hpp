@@ -0,0 +1,329 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine work-stealing scheduler
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_SCHEDULER_HPP_
+#define CPP_BASICS_CORO_SCHEDULER_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+#include <cpp_basics/coro_task.hpp>
+
+namespace coro {
+
+    /**
+     * Handle to a task spawned onto a WorkStealingScheduler, see WorkStealingScheduler::spawn().
+     *
+     * The spawned coroutine frame is shared by the running task and this handle, reference counted,
+     * i.e. the task keeps running if this handle is dropped (detached).
+     *
+     * Its result is retrieved either by `co_await` from a coroutine or by blocking join(),
+     * exactly once and by one consumer.
+     *
+     * @tparam T result type
+     */
+    template<typename T=void>
+    class [[nodiscard]] JoinHandle {
+      public:
+        struct promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        /** Completion state, 0: running, 1: done, otherwise the address of the awaiting coroutine. */
+        constexpr static const uintptr_t state_running = 0;
+        constexpr static const uintptr_t state_done = 1;
+
+        struct final_awaiter {
+            constexpr bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(handle_type h) noexcept {
+                promise_type& p = h.promise();
+                const uintptr_t prev = p.state_.exchange(state_done, std::memory_order_acq_rel);
+                p.state_.notify_all(); // blocking join()
+                std::coroutine_handle<> next = state_done < prev ? std::coroutine_handle<>::from_address(reinterpret_cast<void*>(prev))
+                                                                 : std::noop_coroutine();
+                p.release(h);
+                return next; // symmetric transfer to the awaiting coroutine
+            }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        struct promise_type : impl::promise_value<T> {
+            std::atomic<uintptr_t> state_ = state_running;
+            /** shared by the running coroutine and its JoinHandle */
+            std::atomic<int> refs_ = 2;
+
+            JoinHandle get_return_object() noexcept {
+                return JoinHandle(handle_type::from_promise(*this));
+            }
+            /** Eager, the coroutine body moves itself onto the scheduler. */
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            final_awaiter final_suspend() noexcept { return {}; }
+
+            void release(handle_type h) noexcept {
+                if( 1 == refs_.fetch_sub(1, std::memory_order_acq_rel) ) {
+                    h.destroy();
+                }
+            }
+        };
+
+      private:
+        handle_type h_;
+
+        struct awaiter {
+            handle_type h_;
+
+            bool await_ready() const noexcept {
+                assert( h_ ); // awaiting an empty or moved-from handle
+                return state_done == h_.promise().state_.load(std::memory_order_acquire);
+            }
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                uintptr_t expected = state_running;
+                // false: completed meanwhile, resume the awaiting coroutine right away
+                return h_.promise().state_.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(awaiting.address()),
+                                                                   std::memory_order_acq_rel, std::memory_order_acquire);
+            }
+            T await_resume() { return h_.promise().result(); }
+        };
+
+      public:
+        explicit JoinHandle(handle_type h) noexcept : h_(h) { }
+        JoinHandle(JoinHandle &&o) noexcept : h_(std::exchange(o.h_, {})) { }
+        JoinHandle(const JoinHandle &) = delete;
+        JoinHandle& operator=(JoinHandle &&o) noexcept {
+            if( this != &o ) {
+                if( h_ ) {
+                    h_.promise().release(h_);
+                }
+                h_ = std::exchange(o.h_, {});
+            }
+            return *this;
+        }
+        JoinHandle& operator=(const JoinHandle &) = delete;
+        ~JoinHandle() {
+            if( h_ ) {
+                h_.promise().release(h_);
+            }
+        }
+
+        /** Returns true if the spawned task has completed. */
+        bool done() const noexcept {
+            assert( h_ );
+            return state_done == h_.promise().state_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Blocks the calling thread until the spawned task has completed.
+         *
+         * Shall not be called from a worker thread of the scheduler running the task,
+         * use `co_await` instead.
+         *
+         * @return the task's result, rethrowing its exception
+         */
+        T join() {
+            assert( h_ );
+            std::atomic<uintptr_t>& state = h_.promise().state_;
+            uintptr_t s;
+            while( state_done != ( s = state.load(std::memory_order_acquire) ) ) {
+                state.wait(s, std::memory_order_acquire);
+            }
+            return h_.promise().result();
+        }
+
+        awaiter operator co_await() const & noexcept { return awaiter{h_}; }
+        awaiter operator co_await() const && noexcept { return awaiter{h_}; }
+    };
+
+    /**
+     * Multi-threaded work-stealing scheduler resuming coroutine handles.
+     *
+     * Each worker thread owns a local deque,
+     * handles posted from a worker are pushed to its back and popped LIFO by the owner for cache locality.
+     * An idle worker first drains the global queue receiving handles from non-worker threads,
+     * then steals the oldest handle from the front of another worker's deque, round-robin starting at its neighbor.
+     *
+     * The deques are mutex protected, the owner's lock is uncontended unless being stolen from.
+     * Idle workers sleep on a condition variable and are only notified if sleepers exist.
+     *
+     * A coroutine moves itself onto the scheduler via `co_await sched.schedule()`,
+     * a Task is started on it via spawn().
+     *
+     * The destructor drains all queued handles, then joins the worker threads.
+     */
+    class WorkStealingScheduler {
+      private:
+        struct worker_queue {
+            std::mutex mtx;
+            std::deque<std::coroutine_handle<>> q;
+        };
+
+        static inline thread_local WorkStealingScheduler* tl_sched = nullptr;
+        static inline thread_local size_t tl_worker = 0;
+
+        std::vector<std::unique_ptr<worker_queue>> m_local;
+        worker_queue m_global;
+        std::atomic<size_t> m_queued = 0;
+        std::atomic<size_t> m_steals = 0;
+
+        std::mutex m_idle_mtx;
+        std::condition_variable m_idle_cv;
+        std::atomic<size_t> m_sleepers = 0;
+        bool m_stop = false;
+
+        std::vector<std::thread> m_threads;
+
+        static bool pop_back(worker_queue& wq, std::coroutine_handle<>& h) {
+            std::lock_guard<std::mutex> lock(wq.mtx);
+            if( wq.q.empty() ) {
+                return false;
+            }
+            h = wq.q.back();
+            wq.q.pop_back();
+            return true;
+        }
+        static bool pop_front(worker_queue& wq, std::coroutine_handle<>& h) {
+            std::lock_guard<std::mutex> lock(wq.mtx);
+            if( wq.q.empty() ) {
+                return false;
+            }
+            h = wq.q.front();
+            wq.q.pop_front();
+            return true;
+        }
+
+        bool next(const size_t id, std::coroutine_handle<>& h) {
+            if( pop_back(*m_local[id], h) || pop_front(m_global, h) ) {
+                return true;
+            }
+            const size_t n = m_local.size();
+            for(size_t i = 1; i < n; ++i) {
+                if( pop_front(*m_local[(id + i) % n], h) ) {
+                    m_steals.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(const size_t id) {
+            tl_sched = this;
+            tl_worker = id;
+            std::coroutine_handle<> h;
+            while( true ) {
+                if( next(id, h) ) {
+                    m_queued.fetch_sub(1, std::memory_order_relaxed);
+                    h.resume();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m_idle_mtx);
+                // seq_cst pairs with post(): either the poster sees this sleeper or we see its queued handle
+                m_sleepers.fetch_add(1);
+                m_idle_cv.wait(lock, [&]{ return m_stop || 0 < m_queued.load(); });
+                m_sleepers.fetch_sub(1);
+                if( m_stop && 0 == m_queued.load() ) {
+                    break;
+                }
+            }
+            tl_sched = nullptr;
+        }
+
+      public:
+        /**
+         * Starts the given number of worker threads.
+         * @param threads number of workers, at least one
+         */
+        explicit WorkStealingScheduler(size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<size_t>(1, threads);
+            m_local.reserve(threads);
+            for(size_t i = 0; i < threads; ++i) {
+                m_local.push_back(std::make_unique<worker_queue>());
+            }
+            m_threads.reserve(threads);
+            for(size_t i = 0; i < threads; ++i) {
+                m_threads.emplace_back(&WorkStealingScheduler::run, this, i);
+            }
+        }
+        WorkStealingScheduler(const WorkStealingScheduler &) = delete;
+        WorkStealingScheduler& operator=(const WorkStealingScheduler &) = delete;
+
+        ~WorkStealingScheduler() {
+            {
+                std::lock_guard<std::mutex> lock(m_idle_mtx);
+                m_stop = true;
+            }
+            m_idle_cv.notify_all();
+            for(std::thread& t : m_threads) {
+                t.join();
+            }
+        }
+
+        /** Returns the number of worker threads. */
+        size_t size() const noexcept { return m_threads.size(); }
+
+        /** Returns the number of handles stolen from another worker's deque so far. */
+        size_t steal_count() const noexcept { return m_steals.load(std::memory_order_relaxed); }
+
+        /** Returns true if the calling thread is a worker of this scheduler. */
+        bool on_worker() const noexcept { return this == tl_sched; }
+
+        /**
+         * Queues the given coroutine handle for resumption on a worker thread,
+         * i.e. onto the calling worker's deque or onto the global queue if not called from a worker.
+         */
+        void post(std::coroutine_handle<> h) {
+            worker_queue& wq = on_worker() ? *m_local[tl_worker] : m_global;
+            m_queued.fetch_add(1); // ahead of the push, never underflows
+            {
+                std::lock_guard<std::mutex> lock(wq.mtx);
+                wq.q.push_back(h);
+            }
+            if( 0 < m_sleepers.load() ) {
+                std::lock_guard<std::mutex> lock(m_idle_mtx);
+                m_idle_cv.notify_one();
+            }
+        }
+
+        struct schedule_awaiter {
+            WorkStealingScheduler& sched;
+
+            constexpr bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { sched.post(h); }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        /** Returns an awaitable suspending the awaiting coroutine and resuming it on a worker thread. */
+        schedule_awaiter schedule() noexcept { return schedule_awaiter{*this}; }
+
+        /**
+         * Starts the given task on a worker thread and returns its JoinHandle without waiting.
+         *
+         * Spawning from a worker thread queues the task onto its local deque,
+         * from where it gets stolen by idle workers.
+         */
+        template<typename T>
+        JoinHandle<T> spawn(Task<T> task) {
+            return spawn_impl(*this, std::move(task));
+        }
+
+      private:
+        template<typename T>
+        static JoinHandle<T> spawn_impl(WorkStealingScheduler& sched, Task<T> task) {
+            co_await sched.schedule();
+            co_return co_await task;
+        }
+    };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_SCHEDULER_HPP_ */
@@ -0,0 +1,323 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine Task<T> using symmetric transfer
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_TASK_HPP_
+#define CPP_BASICS_CORO_TASK_HPP_
+
+#include <cstddef>
+#include <cassert>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <type_traits>
+
+namespace coro {
+
+    /** Thrown into a coroutine by a cancellable awaitable after its stop token has been requested to stop. */
+    class operation_cancelled : public std::runtime_error {
+      public:
+        operation_cancelled() : std::runtime_error("operation cancelled") { }
+        explicit operation_cancelled(const char* what) : std::runtime_error(what) { }
+    };
+
+    namespace impl {
+        struct task_group;
+
+        /**
+         * Final awaiter of a Task, resuming the awaiting coroutine via symmetric transfer.
+         *
+         * Returning the continuation's handle from await_suspend() lets the caller tail-call its resume,
+         * i.e. completing a deep chain of awaited tasks does not grow the stack.
+         *
+         * A task started as a member of a task_group arrives at the group instead.
+         */
+        template<typename Promise>
+        struct final_awaiter {
+            constexpr bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                Promise& p = h.promise();
+                if( nullptr != p.group_ ) {
+                    return p.group_->arrive(p);
+                }
+                return p.continuation_;
+            }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        struct promise_base {
+            /** awaiting coroutine, resumed at completion */
+            std::coroutine_handle<> continuation_ = std::noop_coroutine();
+            /** group awaiting this task instead of the continuation, see when_all() and when_any() */
+            task_group* group_ = nullptr;
+            std::exception_ptr exception_;
+            /** cancellation token, inherited from the awaiting coroutine unless set, see this_stop_token() */
+            std::stop_token stop_;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+            void rethrow_if_exception() const {
+                if( exception_ ) {
+                    std::rethrow_exception(exception_);
+                }
+            }
+        };
+
+        /**
+         * Completion countdown of a group of tasks running concurrently, see when_all() and when_any().
+         *
+         * The count is initialized to the number of tasks plus one for the awaiting coroutine,
+         * which arrives after having started all tasks, hence it cannot be resumed while still starting them.
+         * The last arrival resumes the awaiting coroutine via symmetric transfer.
+         */
+        struct task_group {
+            std::atomic<size_t> count_;
+            std::coroutine_handle<> awaiting_;
+            /** requested to stop at the first arrival, if not nullptr */
+            std::stop_source* cancel_;
+            /** first arrived task, only maintained if cancel_ is set */
+            std::atomic<promise_base*> first_ = nullptr;
+
+            explicit task_group(size_t tasks, std::stop_source* cancel = nullptr) noexcept
+            : count_(tasks + 1), cancel_(cancel) { }
+
+            /** Returns the awaiting coroutine to be resumed by the last arrival, otherwise std::noop_coroutine(). */
+            std::coroutine_handle<> arrive(promise_base& p) noexcept {
+                if( nullptr != cancel_ ) {
+                    promise_base* none = nullptr;
+                    if( first_.compare_exchange_strong(none, &p, std::memory_order_acq_rel) ) {
+                        cancel_->request_stop();
+                    }
+                }
+                if( 1 == count_.fetch_sub(1, std::memory_order_acq_rel) ) {
+                    return awaiting_;
+                }
+                return std::noop_coroutine();
+            }
+        };
+
+        template<typename T>
+        struct promise_value : promise_base {
+            std::optional<T> value_;
+
+            template <std::convertible_to<T> From>  // C++20 concept
+            void return_value(From &&from) { value_.emplace(std::forward<From>(from)); }
+
+            T result() {
+                rethrow_if_exception();
+                return std::move(*value_);
+            }
+        };
+
+        template<>
+        struct promise_value<void> : promise_base {
+            void return_void() noexcept { }
+
+            void result() { rethrow_if_exception(); }
+        };
+    } // namespace impl
+
+    /**
+     * Lazy coroutine task producing a value of type `T`, or void.
+     *
+     * The coroutine is started when awaited, not when called (`initial_suspend` is `suspend_always`).
+     * Awaiting a Task suspends the awaiting coroutine and resumes the task,
+     * and the task's completion resumes the awaiting coroutine,
+     * both via symmetric transfer, i.e. `await_suspend` returns the handle to resume next.
+     * Hence deep chains of awaited tasks do not grow the stack, see impl::final_awaiter.
+     * GCC requires `-foptimize-sibling-calls` below `-O2` to emit this tail call.
+     *
+     * An exception escaping the coroutine is rethrown to the awaiting coroutine.
+     *
+     * An awaited task inherits the awaiting coroutine's stop token, if not set already,
+     * hence a cancellation request reaches cancellable awaitables along the whole chain of awaited tasks.
+     *
+     * A Task owns its coroutine frame and is move-only.
+     *
+     * @tparam T result type
+     */
+    template<typename T=void>
+    class [[nodiscard]] Task {
+      public:
+        struct promise_type : impl::promise_value<T> {
+            Task get_return_object() noexcept {
+                return Task(handle_type::from_promise(*this));
+            }
+            impl::final_awaiter<promise_type> final_suspend() noexcept { return {}; }
+        };
+        using handle_type = std::coroutine_handle<promise_type>;
+
+      private:
+        handle_type h_;
+
+        struct awaiter {
+            handle_type h_;
+
+            bool await_ready() const noexcept {
+                assert( h_ ); // awaiting an empty or moved-from task
+                return h_.done();
+            }
+            template<typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) noexcept {
+                h_.promise().continuation_ = awaiting;
+                if constexpr ( std::derived_from<P, impl::promise_base> ) {
+                    if( !h_.promise().stop_.stop_possible() ) {
+                        h_.promise().stop_ = awaiting.promise().stop_;
+                    }
+                }
+                return h_;
+            }
+            T await_resume() { return h_.promise().result(); }
+        };
+
+      public:
+        explicit Task(handle_type h) noexcept : h_(h) { }
+        Task(Task &&o) noexcept : h_(std::exchange(o.h_, {})) { }
+        Task(const Task &) = delete;
+        Task& operator=(Task &&o) noexcept {
+            if( this != &o ) {
+                if( h_ ) {
+                    h_.destroy();
+                }
+                h_ = std::exchange(o.h_, {});
+            }
+            return *this;
+        }
+        Task& operator=(const Task &) = delete;
+        ~Task() {
+            if( h_ ) {
+                h_.destroy();
+            }
+        }
+
+        /** Returns true if the coroutine has completed. */
+        bool done() const noexcept { return !h_ || h_.done(); }
+
+        /** Returns the coroutine handle, owned by this instance. */
+        handle_type handle() const noexcept { return h_; }
+
+        awaiter operator co_await() const & noexcept { return awaiter{h_}; }
+        awaiter operator co_await() const && noexcept { return awaiter{h_}; }
+    };
+
+    namespace impl {
+        /** Stop callback forwarding a stop request to a nested stop source. */
+        struct stop_forwarder {
+            std::stop_source* src;
+            void operator()() const noexcept { src->request_stop(); }
+        };
+
+        struct stop_token_awaiter {
+            std::stop_token token;
+
+            constexpr bool await_ready() const noexcept { return false; }
+            template<std::derived_from<promise_base> P>
+            bool await_suspend(std::coroutine_handle<P> h) noexcept {
+                token = h.promise().stop_;
+                return false;
+            }
+            std::stop_token await_resume() noexcept { return std::move(token); }
+        };
+    } // namespace impl
+
+    /**
+     * Returns an awaitable yielding the stop token of the awaiting Task without suspension,
+     * e.g. `if( (co_await coro::this_stop_token()).stop_requested() ) { ... }`.
+     */
+    inline impl::stop_token_awaiter this_stop_token() noexcept { return {}; }
+
+    namespace impl {
+        /** Completion state of sync_wait(), living on the blocked caller's stack */
+        struct sync_wait_state {
+            std::mutex mtx_;
+            std::condition_variable cv_;
+            bool done_ = false;
+        };
+
+        /** Coroutine awaiting a Task on behalf of sync_wait(), signaling its completion to the blocked caller. */
+        struct sync_wait_task {
+            struct promise_type {
+                sync_wait_state* state_ = nullptr;
+
+                sync_wait_task get_return_object() noexcept {
+                    return sync_wait_task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+                }
+                std::suspend_always initial_suspend() noexcept { return {}; }
+                auto final_suspend() noexcept {
+                    struct notifier {
+                        constexpr bool await_ready() const noexcept { return false; }
+                        void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                            sync_wait_state& st = *h.promise().state_;
+                            // notify while holding the lock, as the caller destroys the state right after
+                            std::lock_guard<std::mutex> lock(st.mtx_);
+                            st.done_ = true;
+                            st.cv_.notify_all();
+                        }
+                        constexpr void await_resume() const noexcept { }
+                    };
+                    return notifier{};
+                }
+                void return_void() noexcept { }
+                void unhandled_exception() noexcept { std::terminate(); } // exceptions are caught within sync_wait_impl()
+            };
+            std::coroutine_handle<promise_type> h_;
+        };
+
+        template<typename T>
+        using sync_wait_result_t = std::optional<std::conditional_t<std::is_void_v<T>, bool, T>>;
+
+        template<typename T>
+        sync_wait_task sync_wait_impl(Task<T>& task, sync_wait_result_t<T>& result, std::exception_ptr& ex) {
+            try {
+                if constexpr ( std::is_void_v<T> ) {
+                    co_await task;
+                    result.emplace(true);
+                } else {
+                    result.emplace(co_await task);
+                }
+            } catch (...) {
+                ex = std::current_exception();
+            }
+        }
+    } // namespace impl
+
+    /**
+     * Runs the given task from a non-coroutine context and blocks until it completes,
+     * which may happen on another thread if the task moves itself onto a scheduler.
+     *
+     * @return the task's result, rethrowing its exception
+     */
+    template<typename T>
+    T sync_wait(Task<T> task) {
+        impl::sync_wait_result_t<T> result;
+        std::exception_ptr ex;
+        impl::sync_wait_state state;
+        impl::sync_wait_task w = impl::sync_wait_impl(task, result, ex);
+        w.h_.promise().state_ = &state;
+        w.h_.resume();
+        {
+            std::unique_lock<std::mutex> lock(state.mtx_);
+            state.cv_.wait(lock, [&]{ return state.done_; });
+        }
+        w.h_.destroy();
+        if( ex ) {
+            std::rethrow_exception(ex);
+        }
+        if constexpr ( !std::is_void_v<T> ) {
+            return std::move(*result);
+        }
+    }
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_TASK_HPP_ */
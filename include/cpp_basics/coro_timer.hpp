@@ -0,0 +1,554 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine timers on a hierarchical timing wheel
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_TIMER_HPP_
+#define CPP_BASICS_CORO_TIMER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cpp_basics/coro_task.hpp>
+#include <cpp_basics/coro_scheduler.hpp>
+
+namespace coro {
+
+    /** Thrown by TimerService::with_deadline() if the deadline expired before the task completed. */
+    class deadline_exceeded : public operation_cancelled {
+      public:
+        deadline_exceeded() : operation_cancelled("deadline exceeded") { }
+    };
+
+    /** Intrusive timer list node, embedded within its owner, e.g. an awaiter within the coroutine frame. */
+    struct timer_node {
+        timer_node* prev = nullptr;
+        timer_node* next = nullptr;
+        /** expiry in ticks */
+        uint64_t expiry = 0;
+        /** invoked once expired */
+        void (*fire)(timer_node*) = nullptr;
+        /** true if expired and linked to the list of timers to be fired */
+        bool pending = false;
+
+        bool linked() const noexcept { return nullptr != next; }
+
+        void unlink() noexcept {
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+    };
+
+    /**
+     * Hierarchical timing wheel of `levels` wheels with `slots` slots each,
+     * level `l` covering timers expiring within `slots^(l+1)` ticks at a resolution of `slots^l` ticks.
+     *
+     * Each slot is an intrusive doubly linked list of timer_node, hence adding and removing a timer is O(1).
+     * Advancing one tick expires the current level-0 slot. Once a level wraps around,
+     * the next slot of the level above is cascaded down, i.e. each timer is relinked at most `levels - 1` times.
+     *
+     * Timers beyond the covered range are parked in the top level's farthest slot and relinked on its cascade.
+     *
+     * next_expiry() returns the next tick expiring or cascading a timer,
+     * which advance() jumps to, skipping all ticks in between w/o any work.
+     *
+     * Not thread-safe, see TimerService.
+     */
+    class TimingWheel {
+      public:
+        constexpr static const unsigned slot_bits = 6;
+        constexpr static const size_t slots = size_t(1) << slot_bits;
+        constexpr static const unsigned levels = 4;
+
+        explicit TimingWheel(uint64_t now = 0) noexcept : m_now(now) {
+            for(unsigned l = 0; l < levels; ++l) {
+                for(size_t s = 0; s < slots; ++s) {
+                    m_slots[l][s].prev = m_slots[l][s].next = &m_slots[l][s];
+                }
+            }
+        }
+        TimingWheel(const TimingWheel &) = delete;
+        TimingWheel& operator=(const TimingWheel &) = delete;
+
+        /** Returns the current tick. */
+        uint64_t now() const noexcept { return m_now; }
+
+        /** Returns the number of linked timers. */
+        size_t size() const noexcept { return m_size; }
+
+        bool empty() const noexcept { return 0 == m_size; }
+
+        /** Links the given timer expiring at the given tick, at the next tick at the earliest. */
+        void add(timer_node& n, uint64_t expiry) noexcept {
+            n.expiry = std::max(expiry, m_now + 1);
+            link(n);
+            ++m_size;
+        }
+
+        /** Unlinks the given linked timer. */
+        void remove(timer_node& n) noexcept {
+            n.unlink();
+            --m_size;
+        }
+
+        /**
+         * Returns the next tick at which a linked timer expires or gets cascaded down,
+         * or `std::numeric_limits<uint64_t>::max()` if no timer is linked.
+         *
+         * Scans at most all `levels * slots` slots, while a cascade tick of a higher level
+         * not preceding the earliest tick found so far ends the scan.
+         */
+        uint64_t next_expiry() const noexcept {
+            uint64_t next = std::numeric_limits<uint64_t>::max();
+            if( 0 == m_size ) {
+                return next;
+            }
+            for(unsigned l = 0; l < levels; ++l) {
+                // level l cascades slot (b & (slots-1)) at tick b << (slot_bits*l), covering one rotation ahead
+                const unsigned shift = slot_bits * l;
+                const uint64_t base = m_now >> shift;
+                if( ( ( base + 1 ) << shift ) >= next ) {
+                    break;
+                }
+                for(uint64_t b = base + 1; b <= base + slots; ++b) {
+                    const timer_node& head = m_slots[l][b & ( slots - 1 )];
+                    if( head.next != &head ) {
+                        next = std::min(next, b << shift);
+                        break;
+                    }
+                }
+            }
+            return next;
+        }
+
+        /**
+         * Advances the wheel to the given tick, unlinking all expired timers and passing each to `expired`.
+         *
+         * Jumps over all ticks neither expiring nor cascading a timer, see next_expiry().
+         */
+        template<std::invocable<timer_node&> F>
+        void advance(uint64_t to, F&& expired) {
+            while( m_now < to ) {
+                const uint64_t next = next_expiry();
+                if( to < next ) {
+                    m_now = to;
+                    break;
+                }
+                m_now = next;
+                cascade();
+                timer_node& head = m_slots[0][m_now & ( slots - 1 )];
+                while( head.next != &head ) {
+                    timer_node& n = *head.next;
+                    remove(n);
+                    expired(n);
+                }
+            }
+        }
+
+      private:
+        timer_node m_slots[levels][slots];
+        uint64_t m_now;
+        size_t m_size = 0;
+
+        static void push_back(timer_node& head, timer_node& n) noexcept {
+            n.prev = head.prev;
+            n.next = &head;
+            head.prev->next = &n;
+            head.prev = &n;
+        }
+
+        void link(timer_node& n) noexcept {
+            const uint64_t delta = n.expiry - m_now;
+            for(unsigned l = 0; l < levels; ++l) {
+                if( delta < ( uint64_t(1) << ( slot_bits * ( l + 1 ) ) ) ) {
+                    push_back(m_slots[l][( n.expiry >> ( slot_bits * l ) ) & ( slots - 1 )], n);
+                    return;
+                }
+            }
+            constexpr unsigned top = levels - 1;
+            push_back(m_slots[top][( ( m_now >> ( slot_bits * top ) ) + slots - 1 ) & ( slots - 1 )], n);
+        }
+
+        /** Relinks the current slot of each level whose lower levels wrapped around, highest first. */
+        void cascade() noexcept {
+            unsigned top = 0;
+            while( top + 1 < levels && 0 == ( m_now & ( ( uint64_t(1) << ( slot_bits * ( top + 1 ) ) ) - 1 ) ) ) {
+                ++top;
+            }
+            for(unsigned l = top; l >= 1; --l) {
+                timer_node& head = m_slots[l][( m_now >> ( slot_bits * l ) ) & ( slots - 1 )];
+                timer_node list; // detach first, relinking may target the same slot
+                if( head.next == &head ) {
+                    continue;
+                }
+                list.next = head.next;
+                list.prev = head.prev;
+                list.next->prev = list.prev->next = &list;
+                head.prev = head.next = &head;
+                while( list.next != &list ) {
+                    timer_node& n = *list.next;
+                    n.unlink();
+                    link(n);
+                }
+            }
+        }
+    };
+
+    /**
+     * Timer facility for coroutines, driving a TimingWheel on its own thread at a fixed tick resolution.
+     *
+     * - `co_await timers.sleep_for(5ms)` suspends the awaiting coroutine for at least the given duration.
+     * - `co_await timers.with_deadline(task, 100ms)` awaits the given task,
+     *   requesting it to stop and throwing deadline_exceeded if the deadline expires first.
+     *
+     * Expired coroutines are resumed on the given WorkStealingScheduler, otherwise on the timer thread.
+     *
+     * Cancellation is cooperative via the Task's std::stop_token, inherited along the chain of awaited tasks.
+     * A suspended sleep_for() awaiter resumes throwing operation_cancelled once stop is requested,
+     * hence the exception unwinds the awaiting chain and each completed frame gets destroyed by its owning Task.
+     * Other awaitables, e.g. coro::Channel, are not cancellable.
+     *
+     * Adding and cancelling a timer takes a mutex and is O(1).
+     * All timers shall be completed or cancelled before destruction.
+     *
+     * The timer thread sleeps until the next tick expiring or cascading a timer, see TimingWheel::next_expiry(),
+     * hence a single long sleep costs a few wakeups only, not one per tick.
+     * The tick resolution trades precision against cascading:
+     * a coarse tick lets each level cover a longer duration, relinking timers less often and waking up less,
+     * while a timer may expire up to one tick late.
+     */
+    class TimerService {
+      public:
+        typedef std::chrono::steady_clock clock_type;
+
+      private:
+        WorkStealingScheduler* m_sched;
+        const clock_type::duration m_tick;
+        const clock_type::time_point m_epoch;
+
+        std::mutex m_mtx;
+        std::condition_variable m_cv;
+        /** signaled after each fired timer, see cancel() */
+        std::condition_variable m_fired_cv;
+        TimingWheel m_wheel;
+        /** expired timers to be fired */
+        timer_node m_pending;
+        /** timer currently fired */
+        timer_node* m_running = nullptr;
+        /** tick the timer thread waits for, an earlier timer added has to wake it */
+        uint64_t m_wait_tick = std::numeric_limits<uint64_t>::max();
+        /** resumed on the timer thread w/o scheduler */
+        std::vector<std::coroutine_handle<>> m_ready;
+        bool m_stop = false;
+
+        std::thread m_thread;
+
+        uint64_t to_tick(clock_type::time_point tp) const noexcept {
+            return tp <= m_epoch ? 0 : uint64_t( ( tp - m_epoch ) / m_tick );
+        }
+        /** Returns the first tick at or after the given time point, never expiring early */
+        uint64_t to_tick_ceil(clock_type::time_point tp) const noexcept {
+            return tp <= m_epoch ? 0 : uint64_t( ( tp - m_epoch + m_tick - clock_type::duration(1) ) / m_tick );
+        }
+
+        void run() {
+            std::vector<std::coroutine_handle<>> ready;
+            std::unique_lock<std::mutex> lock(m_mtx);
+            while( true ) {
+                if( !m_ready.empty() ) {
+                    ready.swap(m_ready);
+                    lock.unlock();
+                    for(std::coroutine_handle<> h : ready) {
+                        h.resume();
+                    }
+                    ready.clear();
+                    lock.lock();
+                    continue;
+                }
+                if( m_stop ) {
+                    break;
+                }
+                if( m_wheel.empty() ) {
+                    m_wait_tick = std::numeric_limits<uint64_t>::max();
+                    m_cv.wait(lock, [&]{ return m_stop || !m_wheel.empty() || !m_ready.empty(); });
+                    continue;
+                }
+                m_wait_tick = m_wheel.next_expiry();
+                const clock_type::time_point next = m_epoch + m_tick * m_wait_tick;
+                if( clock_type::now() < next ) {
+                    m_cv.wait_until(lock, next);
+                    continue;
+                }
+                m_wheel.advance(to_tick(clock_type::now()), [&](timer_node& n) {
+                    n.pending = true;
+                    n.prev = m_pending.prev;
+                    n.next = &m_pending;
+                    m_pending.prev->next = &n;
+                    m_pending.prev = &n;
+                });
+                // fire w/o holding the lock, a fired timer may request stop and cancel other timers
+                while( m_pending.next != &m_pending ) {
+                    timer_node& n = *m_pending.next;
+                    n.unlink();
+                    n.pending = false;
+                    m_running = &n;
+                    lock.unlock();
+                    n.fire(&n);
+                    lock.lock();
+                    m_running = nullptr;
+                    m_fired_cv.notify_all();
+                }
+            }
+        }
+
+      public:
+        /**
+         * Starts the timer thread.
+         * @param sched optional scheduler to resume expired coroutines on, otherwise resumed on the timer thread
+         * @param tick timer resolution
+         */
+        explicit TimerService(WorkStealingScheduler* sched = nullptr, clock_type::duration tick = std::chrono::milliseconds(1))
+        : m_sched(sched), m_tick(tick), m_epoch(clock_type::now())
+        {
+            m_pending.prev = m_pending.next = &m_pending;
+            m_thread = std::thread(&TimerService::run, this);
+        }
+        TimerService(const TimerService &) = delete;
+        TimerService& operator=(const TimerService &) = delete;
+
+        ~TimerService() {
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            m_thread.join();
+        }
+
+        /** Returns the timer resolution. */
+        clock_type::duration tick() const noexcept { return m_tick; }
+
+        /** Returns the number of armed timers. */
+        size_t size() {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            return m_wheel.size();
+        }
+
+        /** Resumes the given coroutine on the scheduler, otherwise on the timer thread. */
+        void post(std::coroutine_handle<> h) {
+            if( m_sched ) {
+                m_sched->post(h);
+            } else {
+                {
+                    std::lock_guard<std::mutex> lock(m_mtx);
+                    m_ready.push_back(h);
+                }
+                m_cv.notify_one();
+            }
+        }
+
+        /**
+         * Arms the given timer, its `fire` callback is invoked on the timer thread at or after the given time point.
+         *
+         * @param stop optional stop token, checked while holding the lock cancel() takes, see sleep_awaiter
+         * @return false if not armed, as `stop` has been requested to stop
+         */
+        bool add(timer_node& n, clock_type::time_point when, const std::stop_token* stop = nullptr) {
+            bool wake;
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                if( stop && stop->stop_requested() ) {
+                    return false;
+                }
+                if( m_wheel.empty() ) {
+                    m_wheel.advance(to_tick(clock_type::now()), [](timer_node&) { });
+                }
+                m_wheel.add(n, to_tick_ceil(when));
+                wake = n.expiry < m_wait_tick;
+            }
+            if( wake ) {
+                m_cv.notify_one();
+            }
+            return true;
+        }
+
+        /**
+         * Disarms the given timer.
+         *
+         * If the timer has expired already, waits until its `fire` callback has returned unless called from it.
+         * @return true if disarmed before expiry, i.e. `fire` won't be invoked
+         */
+        bool cancel(timer_node& n) {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            if( n.linked() ) {
+                if( n.pending ) {
+                    n.unlink();
+                    n.pending = false;
+                } else {
+                    m_wheel.remove(n);
+                }
+                return true;
+            }
+            if( std::this_thread::get_id() != m_thread.get_id() ) {
+                m_fired_cv.wait(lock, [&]{ return m_running != &n; });
+            }
+            return false;
+        }
+
+        /** Awaitable suspending until its time point, see sleep_for(). */
+        class sleep_awaiter : private timer_node {
+          public:
+            sleep_awaiter(TimerService& svc, clock_type::time_point when) noexcept : m_svc(svc), m_when(when) { }
+            sleep_awaiter(const sleep_awaiter &) = delete;
+            sleep_awaiter& operator=(const sleep_awaiter &) = delete;
+            ~sleep_awaiter() {
+                m_stop_cb.reset();
+                if( m_armed ) {
+                    m_svc.cancel(*this); // frame destroyed while suspended
+                }
+            }
+
+            bool await_ready() const noexcept { return clock_type::now() >= m_when; }
+
+            template<typename P>
+            bool await_suspend(std::coroutine_handle<P> h) {
+                m_handle = h;
+                this->fire = &sleep_awaiter::expired;
+                m_armed = true;
+                if constexpr ( std::derived_from<P, impl::promise_base> ) {
+                    const std::stop_token& st = h.promise().stop_;
+                    if( st.stop_possible() ) {
+                        // a stop request ahead of add() finds the timer not armed, the one after cancels it
+                        m_stop_cb.emplace(st, canceller{this});
+                        if( !m_svc.add(*this, m_when, &st) ) {
+                            m_armed = false;
+                            m_cancelled = true;
+                            return false;
+                        }
+                        return true; // may be resumed by another thread already, not touching this awaiter anymore
+                    }
+                }
+                m_svc.add(*this, m_when);
+                return true;
+            }
+
+            /** Throws operation_cancelled if stop has been requested. */
+            void await_resume() {
+                m_armed = false;
+                if( m_cancelled ) {
+                    throw operation_cancelled();
+                }
+            }
+
+          private:
+            struct canceller {
+                sleep_awaiter* a;
+                void operator()() const noexcept {
+                    if( a->m_svc.cancel(*a) ) {
+                        a->m_cancelled = true;
+                        a->m_svc.post(a->m_handle);
+                    }
+                }
+            };
+
+            static void expired(timer_node* n) {
+                sleep_awaiter* a = static_cast<sleep_awaiter*>(n);
+                a->m_svc.post(a->m_handle);
+            }
+
+            TimerService& m_svc;
+            clock_type::time_point m_when;
+            std::coroutine_handle<> m_handle;
+            std::optional<std::stop_callback<canceller>> m_stop_cb;
+            bool m_armed = false;
+            bool m_cancelled = false;
+        };
+
+        /**
+         * Returns an awaitable suspending the awaiting coroutine until the given time point,
+         * throwing operation_cancelled if its Task's stop token is requested to stop.
+         */
+        [[nodiscard]] sleep_awaiter sleep_until(clock_type::time_point when) noexcept { return sleep_awaiter(*this, when); }
+
+        /** Returns an awaitable suspending the awaiting coroutine for at least the given duration, see sleep_until(). */
+        [[nodiscard]] sleep_awaiter sleep_for(clock_type::duration d) noexcept { return sleep_awaiter(*this, clock_type::now() + d); }
+
+        /**
+         * Returns a Task awaiting the given task, requesting it to stop once the given timeout expires.
+         *
+         * The given task inherits a stop token, which is also requested to stop with the awaiting Task's stop token.
+         * @return the task's result, throwing deadline_exceeded if the task got cancelled by the deadline
+         */
+        template<typename T>
+        Task<T> with_deadline(Task<T> task, clock_type::duration timeout) {
+            return with_deadline_impl(*this, std::move(task), clock_type::now() + timeout);
+        }
+
+      private:
+        /** Armed for the lifetime of with_deadline_impl(), requesting stop on expiry. */
+        class deadline_timer : private timer_node {
+          public:
+            deadline_timer(TimerService& svc, clock_type::time_point when, std::stop_source& src) : m_svc(svc), m_src(src) {
+                this->fire = &deadline_timer::expired;
+                m_svc.add(*this, when);
+            }
+            deadline_timer(const deadline_timer &) = delete;
+            deadline_timer& operator=(const deadline_timer &) = delete;
+            ~deadline_timer() { m_svc.cancel(*this); }
+
+            bool has_expired() const noexcept { return m_expired.load(); }
+
+          private:
+            static void expired(timer_node* n) {
+                deadline_timer* d = static_cast<deadline_timer*>(n);
+                d->m_expired.store(true);
+                d->m_src.request_stop();
+            }
+
+            TimerService& m_svc;
+            std::stop_source& m_src;
+            std::atomic<bool> m_expired = false;
+        };
+
+        template<typename T>
+        static Task<T> with_deadline_impl(TimerService& svc, Task<T> task, clock_type::time_point when) {
+            std::stop_source src;
+            std::optional<std::stop_callback<impl::stop_forwarder>> forward;
+            {
+                std::stop_token outer = co_await this_stop_token();
+                if( outer.stop_possible() ) {
+                    forward.emplace(outer, impl::stop_forwarder{&src});
+                }
+            }
+            task.handle().promise().stop_ = src.get_token();
+            deadline_timer deadline(svc, when, src);
+            try {
+                co_return co_await task;
+            } catch (const operation_cancelled&) {
+                if( deadline.has_expired() ) {
+                    throw deadline_exceeded();
+                }
+                throw;
+            }
+        }
+    };
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_TIMER_HPP_ */
@@ -0,0 +1,312 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Lazy single-pass range adaptors for Generator<T>
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_VIEWS_HPP_
+#define CPP_BASICS_CORO_VIEWS_HPP_
+
+#include <cstddef>
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Lazy single-pass range adaptors `filter`, `transform`, `take` and `chunk`,
+ * applicable to any input range and composable via `operator|`, e.g. coro::Generator:
+ * <pre>
+ *   auto pipeline = numbers()
+ *                 | coro::views::filter([](int v) { return 0 == v % 2; })
+ *                 | coro::views::transform([](int v) { return v * 3; })
+ *                 | coro::views::take(1000)
+ *                 | coro::views::chunk(64);
+ *   for(std::span<const int> c : pipeline) { ... }
+ * </pre>
+ *
+ * Each stage's iterator pulls from its base iterator directly,
+ * i.e. the stages fuse into the consumer's pull loop without intermediate containers or coroutine frames
+ * and process a stream in constant memory.
+ *
+ * Unlike the std::views counterparts, all adaptors only model single-pass std::ranges::input_range,
+ * hence begin() shall be called once. In turn they avoid caching and extra base increments,
+ * e.g. `take(n)` never resumes a generator beyond its n-th value.
+ * `chunk(n)` is available before C++23 and yields a `std::span` over a reused buffer of up to n values.
+ */
+namespace coro::views {
+
+    namespace impl {
+        /** Range adaptor closure, applied via `range | closure`. */
+        template<typename F>
+        struct closure {
+            F make;
+
+            template<std::ranges::viewable_range R>
+            friend auto operator|(R&& r, closure c) {
+                return c.make(std::views::all(std::forward<R>(r)));
+            }
+        };
+
+        template<typename F>
+        closure(F) -> closure<F>;
+    }
+
+    template<std::ranges::input_range V, typename Pred>
+    requires std::ranges::view<V> && std::indirect_unary_predicate<const Pred, std::ranges::iterator_t<V>>
+    class filter_view : public std::ranges::view_base {
+      private:
+        V m_base;
+        Pred m_pred;
+
+      public:
+        class iterator {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            decltype(auto) operator*() const { return *m_it; }
+
+            iterator& operator++() {
+                ++m_it;
+                satisfy();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) { return i.at_end(); }
+
+          private:
+            friend class filter_view;
+            filter_view* m_parent = nullptr;
+            std::ranges::iterator_t<V> m_it;
+
+            iterator(filter_view& parent, std::ranges::iterator_t<V> it) : m_parent(&parent), m_it(std::move(it)) { satisfy(); }
+
+            bool at_end() const { return m_it == std::ranges::end(m_parent->m_base); }
+
+            void satisfy() {
+                const auto end = std::ranges::end(m_parent->m_base);
+                while( m_it != end && !std::invoke(m_parent->m_pred, *m_it) ) {
+                    ++m_it;
+                }
+            }
+        };
+
+        filter_view(V base, Pred pred) : m_base(std::move(base)), m_pred(std::move(pred)) { }
+
+        iterator begin() { return iterator(*this, std::ranges::begin(m_base)); }
+        constexpr std::default_sentinel_t end() const noexcept { return {}; }
+    };
+
+    template<std::ranges::input_range V, typename F>
+    requires std::ranges::view<V> && std::regular_invocable<const F&, std::ranges::range_reference_t<V>>
+    class transform_view : public std::ranges::view_base {
+      private:
+        V m_base;
+        F m_fun;
+
+      public:
+        class iterator {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::remove_cvref_t<std::invoke_result_t<const F&, std::ranges::range_reference_t<V>>>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            decltype(auto) operator*() const { return std::invoke(m_parent->m_fun, *m_it); }
+
+            iterator& operator++() {
+                ++m_it;
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) { return i.at_end(); }
+
+          private:
+            friend class transform_view;
+            transform_view* m_parent = nullptr;
+            std::ranges::iterator_t<V> m_it;
+
+            iterator(transform_view& parent, std::ranges::iterator_t<V> it) : m_parent(&parent), m_it(std::move(it)) { }
+
+            bool at_end() const { return m_it == std::ranges::end(m_parent->m_base); }
+        };
+
+        transform_view(V base, F fun) : m_base(std::move(base)), m_fun(std::move(fun)) { }
+
+        iterator begin() { return iterator(*this, std::ranges::begin(m_base)); }
+        constexpr std::default_sentinel_t end() const noexcept { return {}; }
+    };
+
+    template<std::ranges::input_range V>
+    requires std::ranges::view<V>
+    class take_view : public std::ranges::view_base {
+      private:
+        V m_base;
+        size_t m_count;
+
+      public:
+        class iterator {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::ranges::range_value_t<V>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            decltype(auto) operator*() const { return *m_it; }
+
+            /** Doesn't advance the base iterator after the last taken value. */
+            iterator& operator++() {
+                if( 0 < --m_left ) {
+                    ++m_it;
+                }
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) { return i.at_end(); }
+
+          private:
+            friend class take_view;
+            take_view* m_parent = nullptr;
+            std::ranges::iterator_t<V> m_it;
+            size_t m_left = 0;
+
+            iterator(take_view& parent, std::ranges::iterator_t<V> it, size_t left) : m_parent(&parent), m_it(std::move(it)), m_left(left) { }
+
+            bool at_end() const { return 0 == m_left || m_it == std::ranges::end(m_parent->m_base); }
+        };
+
+        take_view(V base, size_t count) : m_base(std::move(base)), m_count(count) { }
+
+        /** Doesn't start the base range, e.g. resuming a generator, for a zero count. */
+        iterator begin() {
+            if( 0 == m_count ) {
+                return iterator(*this, {}, 0);
+            }
+            return iterator(*this, std::ranges::begin(m_base), m_count);
+        }
+        constexpr std::default_sentinel_t end() const noexcept { return {}; }
+    };
+
+    template<std::ranges::input_range V>
+    requires std::ranges::view<V>
+    class chunk_view : public std::ranges::view_base {
+      public:
+        typedef std::ranges::range_value_t<V> value_t;
+
+      private:
+        V m_base;
+        size_t m_size;
+        /** reused buffer of the current chunk */
+        std::vector<value_t> m_chunk;
+
+      public:
+        class iterator {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = std::span<const value_t>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            /** Returns the current chunk, valid until the next increment. */
+            std::span<const value_t> operator*() const noexcept { return m_parent->chunk(); }
+
+            iterator& operator++() {
+                fill();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) noexcept { return i.at_end(); }
+
+          private:
+            friend class chunk_view;
+            chunk_view* m_parent = nullptr;
+            std::ranges::iterator_t<V> m_it;
+
+            iterator(chunk_view& parent, std::ranges::iterator_t<V> it) : m_parent(&parent), m_it(std::move(it)) { fill(); }
+
+            bool at_end() const noexcept { return m_parent->m_chunk.empty(); }
+
+            /** true if the base iterator still refers to the last value of the current chunk */
+            bool m_advance = false;
+
+            /** Defers the increment after a chunk's last value to the next chunk, e.g. not resuming a generator early. */
+            void fill() {
+                std::vector<value_t>& chunk = m_parent->m_chunk;
+                const auto end = std::ranges::end(m_parent->m_base);
+                chunk.clear();
+                if( m_advance ) {
+                    ++m_it;
+                    m_advance = false;
+                }
+                while( m_it != end ) {
+                    chunk.push_back(*m_it);
+                    if( chunk.size() == m_parent->m_size ) {
+                        m_advance = true;
+                        break;
+                    }
+                    ++m_it;
+                }
+            }
+        };
+
+        chunk_view(V base, size_t size) : m_base(std::move(base)), m_size(std::max<size_t>(1, size)) {
+            m_chunk.reserve(m_size);
+        }
+
+        iterator begin() { return iterator(*this, std::ranges::begin(m_base)); }
+        constexpr std::default_sentinel_t end() const noexcept { return {}; }
+
+      private:
+        std::span<const value_t> chunk() const noexcept { return std::span<const value_t>(m_chunk); }
+    };
+
+    /** Lazily skips values not satisfying the given predicate. */
+    template<typename Pred>
+    auto filter(Pred pred) {
+        return impl::closure{ [p = std::move(pred)]<typename V>(V base) mutable {
+            return filter_view<V, Pred>(std::move(base), std::move(p));
+        } };
+    }
+
+    /** Lazily maps each value via the given function. */
+    template<typename F>
+    auto transform(F fun) {
+        return impl::closure{ [f = std::move(fun)]<typename V>(V base) mutable {
+            return transform_view<V, F>(std::move(base), std::move(f));
+        } };
+    }
+
+    /** Lazily yields up to the given number of values. */
+    inline auto take(size_t count) {
+        return impl::closure{ [count]<typename V>(V base) {
+            return take_view<V>(std::move(base), count);
+        } };
+    }
+
+    /** Lazily groups the values into chunks of the given size, the last chunk may be smaller. */
+    inline auto chunk(size_t size) {
+        return impl::closure{ [size]<typename V>(V base) {
+            return chunk_view<V>(std::move(base), size);
+        } };
+    }
+
+} // namespace coro::views
+
+#endif /* CPP_BASICS_CORO_VIEWS_HPP_ */
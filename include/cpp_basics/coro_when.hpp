@@ -0,0 +1,205 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine combinators when_all() and when_any()
+//===============================================================================
+
+#ifndef CPP_BASICS_CORO_WHEN_HPP_
+#define CPP_BASICS_CORO_WHEN_HPP_
+
+#include <cstddef>
+#include <coroutine>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <cpp_basics/coro_task.hpp>
+#include <cpp_basics/coro_scheduler.hpp>
+
+namespace coro {
+
+    namespace impl {
+        /** Result value of a grouped Task<T>, std::monostate for void. */
+        template<typename T>
+        using when_value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        /** Returns the completed task's result, rethrowing its exception. */
+        template<typename T>
+        when_value_t<T> when_value(Task<T>& task) {
+            if constexpr ( std::is_void_v<T> ) {
+                task.handle().promise().result();
+                return {};
+            } else {
+                return task.handle().promise().result();
+            }
+        }
+
+        /** Adds the given not yet started task to the group and queues it onto the scheduler. */
+        template<typename T>
+        void start_member(WorkStealingScheduler& sched, task_group& group, Task<T>& task, const std::stop_token& stop) {
+            typename Task<T>::handle_type h = task.handle();
+            h.promise().group_ = &group;
+            if( !h.promise().stop_.stop_possible() ) {
+                h.promise().stop_ = stop;
+            }
+            sched.post(h);
+        }
+
+        /**
+         * Awaiter moving the awaiting coroutine onto a worker thread unless running on one already,
+         * so starting a group queues its tasks onto the worker's local deque instead of waking up a worker per task.
+         */
+        struct onto_worker {
+            WorkStealingScheduler& sched;
+
+            bool await_ready() const noexcept { return sched.on_worker(); }
+            void await_suspend(std::coroutine_handle<> h) { sched.post(h); }
+            constexpr void await_resume() const noexcept { }
+        };
+
+        /**
+         * Awaiter starting all tasks of a group via `start()`, then arriving itself,
+         * i.e. suspends the awaiting coroutine until the last task has completed, if any is still running.
+         */
+        template<typename Start>
+        struct group_awaiter {
+            task_group& group;
+            Start start;
+
+            // not an aggregate, see elements_of
+            group_awaiter(task_group& g, Start s) noexcept : group(g), start(std::move(s)) { }
+
+            constexpr bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> awaiting) {
+                group.awaiting_ = awaiting;
+                start();
+                return 1 != group.count_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            constexpr void await_resume() const noexcept { }
+        };
+    } // namespace impl
+
+    /**
+     * Returns a task running all given tasks concurrently on the scheduler,
+     * completing with all their results once the last has completed, i.e. fan-out and fan-in.
+     *
+     * No thread blocks, the awaiting coroutine is suspended and resumed by the last completing task
+     * via symmetric transfer, i.e. continues on a worker thread.
+     * Started from another thread, the group first moves onto a worker to queue its tasks locally, see impl::onto_worker.
+     *
+     * The group is awaited via a single atomic countdown within the returned task's frame, see impl::task_group.
+     * Each task arrives at its completion directly, i.e. w/o an additional wrapper coroutine or heap allocation per task.
+     *
+     * Tasks inherit the awaiting coroutine's stop token, unless set.
+     * All tasks run to completion, then the first exception in argument order is rethrown.
+     *
+     * @param sched scheduler running the tasks
+     * @param tasks not yet started tasks
+     * @return task yielding a tuple of all results in argument order, std::monostate for void
+     */
+    template<typename... Ts>
+    Task<std::tuple<impl::when_value_t<Ts>...>> when_all(WorkStealingScheduler& sched, Task<Ts>... tasks) {
+        const std::stop_token stop = co_await this_stop_token();
+        co_await impl::onto_worker{sched};
+        impl::task_group group(sizeof...(Ts));
+        co_await impl::group_awaiter(group, [&]() {
+            ( impl::start_member(sched, group, tasks, stop), ... );
+        });
+        co_return std::tuple<impl::when_value_t<Ts>...>{ impl::when_value(tasks)... }; // braced, evaluated in order
+    }
+
+    /**
+     * Returns a task running all given tasks concurrently on the scheduler,
+     * completing with all their results once the last has completed, see the variadic when_all().
+     *
+     * @param sched scheduler running the tasks
+     * @param tasks not yet started tasks
+     * @return task yielding a vector of all results in order, or void
+     */
+    template<typename T>
+    Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> when_all(WorkStealingScheduler& sched, std::vector<Task<T>> tasks) {
+        const std::stop_token stop = co_await this_stop_token();
+        co_await impl::onto_worker{sched};
+        impl::task_group group(tasks.size());
+        co_await impl::group_awaiter(group, [&]() {
+            for(Task<T>& t : tasks) {
+                impl::start_member(sched, group, t, stop);
+            }
+        });
+        if constexpr ( std::is_void_v<T> ) {
+            for(Task<T>& t : tasks) {
+                t.handle().promise().result();
+            }
+        } else {
+            std::vector<T> res;
+            res.reserve(tasks.size());
+            for(Task<T>& t : tasks) {
+                res.push_back(t.handle().promise().result());
+            }
+            co_return res;
+        }
+    }
+
+    /** Result of when_any(), the index of the first completed task and its result. */
+    template<typename T>
+    struct when_any_result {
+        size_t index;
+        impl::when_value_t<T> value;
+    };
+
+    /**
+     * Returns a task running all given tasks concurrently on the scheduler,
+     * completing with the result of the first completed task.
+     *
+     * The first completion requests all tasks to stop via their shared stop token,
+     * forwarded from the awaiting coroutine's stop token, see this_stop_token().
+     * Like when_all(), the returned task completes only after all tasks have completed,
+     * hence no task outlives its frame. A task ignoring the stop request delays the result.
+     *
+     * Tasks w/ their own stop token set are not cancelled.
+     * The first task's exception is rethrown, all others are dropped.
+     *
+     * @param sched scheduler running the tasks
+     * @param tasks not yet started tasks, at least one
+     * @return task yielding the first completed task's index and result, std::monostate for void
+     * @throws std::invalid_argument if no task is given
+     */
+    template<typename T>
+    Task<when_any_result<T>> when_any(WorkStealingScheduler& sched, std::vector<Task<T>> tasks) {
+        if( tasks.empty() ) {
+            throw std::invalid_argument("when_any of no tasks");
+        }
+        std::stop_source cancel;
+        std::optional<std::stop_callback<impl::stop_forwarder>> forward;
+        {
+            std::stop_token outer = co_await this_stop_token();
+            if( outer.stop_possible() ) {
+                forward.emplace(outer, impl::stop_forwarder{&cancel});
+            }
+        }
+        const std::stop_token stop = cancel.get_token();
+        co_await impl::onto_worker{sched};
+        impl::task_group group(tasks.size(), &cancel);
+        co_await impl::group_awaiter(group, [&]() {
+            for(Task<T>& t : tasks) {
+                impl::start_member(sched, group, t, stop);
+            }
+        });
+        const impl::promise_base* first = group.first_.load(std::memory_order_acquire);
+        size_t i = 0;
+        while( &tasks[i].handle().promise() != first ) {
+            ++i;
+        }
+        when_any_result<T> res{ i, impl::when_value(tasks[i]) };
+        co_return std::move(res);
+    }
+
+} // namespace coro
+
+#endif /* CPP_BASICS_CORO_WHEN_HPP_ */
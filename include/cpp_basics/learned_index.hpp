@@ -0,0 +1,193 @@
+//============================================================================
+// Author      : Svenson Han Göthel and Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Learned index of a sorted array using piecewise linear models
+//============================================================================
+
+#ifndef CPP_BASICS_LEARNED_INDEX_HPP_
+#define CPP_BASICS_LEARNED_INDEX_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+
+#include "cpp_basics/search.hpp"
+
+/**
+ * Read-only learned index of a sorted array, PGM-index style.
+ *
+ * The position of a key is predicted by a piecewise linear model,
+ * where each segment guarantees a maximum prediction error of `epsilon` positions
+ * for all keys it covers. The segments are fitted in one pass by shrinking the cone
+ * of feasible slopes from each segment's first key until the cone becomes empty.
+ *
+ * The segments' first keys are indexed recursively by further levels of segments
+ * with error bound `epsilon_recursive`, until a single root segment remains.
+ * A lookup hence descends all levels, searching only a small error window at each level,
+ * followed by the last-mile lower_bound_branchless() within `2 epsilon + 3` keys of the array.
+ *
+ * Duplicate keys are modeled at their first position, matching the lower bound.
+ * Only a miss following a run of duplicates longer than `epsilon` may exceed the window,
+ * which is then continued by lower_bound_exponential().
+ * The memory overhead is independent of the key count for smooth distributions, e.g. timestamps,
+ * see segment_count() and memory_usage().
+ *
+ * @tparam K arithmetic key type
+ * @tparam epsilon maximum prediction error of the bottom level in array positions
+ * @tparam epsilon_recursive maximum prediction error of the upper levels in segment positions
+ */
+template<typename K, size_t epsilon=64, size_t epsilon_recursive=4>
+requires std::is_arithmetic_v<K>
+class PGMIndex {
+  private:
+    static_assert(epsilon >= 1 && epsilon_recursive >= 1, "error bounds must be at least one position");
+
+    struct segment {
+        /** first key covered */
+        K key;
+        /** positions per key unit */
+        double slope;
+        /** position of the first key covered */
+        size_t pos;
+    };
+
+    std::span<const K> m_data;
+    /** levels of segments, starting with the bottom level over m_data */
+    std::vector<std::vector<segment>> m_levels;
+
+    /**
+     * Fits segments over `n` sorted keys, returned by `key(i)`, with maximum error `eps`.
+     */
+    template<typename F>
+    static std::vector<segment> fit(size_t n, F key, size_t eps) {
+        std::vector<segment> segments;
+        // one position of slack covers the rounding of the floating point prediction
+        const double e = double(eps) - 1.0;
+        size_t i = 0;
+        while( i < n ) {
+            const size_t start = i;
+            double slope_lo = 0, slope_hi = std::numeric_limits<double>::infinity();
+            size_t j = start + 1;
+            for(; j < n; ++j) {
+                if( key(j) == key(j-1) ) {
+                    continue; // duplicates are covered by their first position
+                }
+                const double dx = double( key(j) ) - double( key(start) ); // avoid overflow of a signed K
+                const double dy = double(j - start);
+                const double lo = std::max(slope_lo, ( dy - e ) / dx);
+                const double hi = std::min(slope_hi, ( dy + e ) / dx);
+                if( lo > hi ) {
+                    break;
+                }
+                slope_lo = lo;
+                slope_hi = hi;
+            }
+            const double slope = slope_hi < std::numeric_limits<double>::infinity() ? ( slope_lo + slope_hi ) / 2.0 : 0.0;
+            segments.push_back( { key(start), slope, start } );
+            i = j;
+        }
+        return segments;
+    }
+
+    /**
+     * Returns the predicted position of `x` by segment `s`, clamped to the positions covered,
+     * with `end` being the position following the covered ones.
+     * @param x target value greater than the segment's first key
+     */
+    static size_t predict(const segment& s, size_t end, const K& x) noexcept {
+        // a steep slope may extrapolate far beyond the segment, e.g. for closely spaced floating point keys
+        const double p = double(s.pos) + s.slope * ( double( x ) - double( s.key ) );
+        if( std::isnan(p) ) {
+            return end;
+        }
+        return size_t( std::clamp(p, double(s.pos), double(end)) );
+    }
+
+  public:
+    /**
+     * Builds the index over the given sorted array.
+     * @param sorted sorted array, referenced and must outlive this instance
+     */
+    PGMIndex(std::span<const K> sorted)
+    : m_data(sorted)
+    {
+        if( 0 == sorted.size() ) {
+            return;
+        }
+        m_levels.push_back( fit(sorted.size(), [&](size_t i) { return sorted[i]; }, epsilon) );
+        while( m_levels.back().size() > 1 ) {
+            const std::vector<segment>& below = m_levels.back();
+            m_levels.push_back( fit(below.size(), [&](size_t i) { return below[i].key; }, epsilon_recursive) );
+        }
+    }
+    PGMIndex(const std::vector<K>& sorted)
+    : PGMIndex(std::span<const K>(sorted)) {}
+
+    /** Returns the number of elements. */
+    size_t size() const noexcept { return m_data.size(); }
+
+    /** Returns the number of levels. */
+    size_t height() const noexcept { return m_levels.size(); }
+
+    /** Returns the number of segments of all levels. */
+    size_t segment_count() const noexcept {
+        size_t c = 0;
+        for(const std::vector<segment>& l : m_levels) { c += l.size(); }
+        return c;
+    }
+
+    /** Returns the memory usage of all segments in bytes, excluding the referenced array. */
+    size_t memory_usage() const noexcept {
+        return segment_count() * sizeof(segment) + m_levels.size() * sizeof(std::vector<segment>);
+    }
+
+    /**
+     * Returns the index of the first element not less than `target_value`, or size() if none exists.
+     */
+    size_t lower_bound(const K& target_value) const noexcept {
+        if( m_levels.empty() || !( m_levels[0][0].key < target_value ) ) {
+            return 0;
+        }
+        // descend to the last bottom segment whose first key is less than `target_value`
+        size_t s = 0;
+        for(size_t h = m_levels.size() - 1; h > 0; --h) {
+            const segment& seg = m_levels[h][s];
+            const std::vector<segment>& below = m_levels[h-1];
+            const size_t end = s + 1 < m_levels[h].size() ? m_levels[h][s+1].pos : below.size();
+            const size_t p = predict(seg, end, target_value);
+            const size_t lo = std::max(seg.pos, p > epsilon_recursive + 1 ? p - epsilon_recursive - 1 : 0);
+            const size_t hi = std::min(end, p + epsilon_recursive + 2);
+            const auto it = std::lower_bound(below.cbegin() + ptrdiff_t(lo), below.cbegin() + ptrdiff_t(hi), target_value,
+                                             [](const segment& a, const K& x) { return a.key < x; });
+            s = size_t( it - below.cbegin() ) - 1;
+        }
+        // last mile within the error window
+        const std::vector<segment>& bottom = m_levels[0];
+        const segment& seg = bottom[s];
+        const size_t end = s + 1 < bottom.size() ? bottom[s+1].pos : m_data.size();
+        const size_t p = predict(seg, end, target_value);
+        const size_t lo = std::max(seg.pos, p > epsilon + 1 ? p - epsilon - 1 : 0);
+        const size_t hi = std::min(end, p + epsilon + 2);
+        const size_t i = lo + lower_bound_branchless(m_data.subspan(lo, hi - lo), target_value);
+        // a miss following a run of duplicates longer than the error bound may exceed the window
+        if( i == hi && hi < end && m_data[hi] < target_value ) {
+            return seg.pos + lower_bound_exponential(m_data.subspan(seg.pos, end - seg.pos), target_value, hi - seg.pos);
+        }
+        return i;
+    }
+
+    /**
+     * Returns the index of the first element equal to `target_value`, otherwise no_index.
+     */
+    size_t binary_search(const K& target_value) const noexcept {
+        const size_t i = lower_bound(target_value);
+        return i < m_data.size() && m_data[i] == target_value ? i : no_index;
+    }
+};
+
+#endif /* CPP_BASICS_LEARNED_INDEX_HPP_ */
@@ -0,0 +1,1265 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 A divide-and-conquer algorithm (quicksort)
+//===============================================================================
+
+#ifndef CPP_BASICS_QSORT_HPP_
+#define CPP_BASICS_QSORT_HPP_
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace impl_common {
+
+    template<typename V>
+    void printVec(const std::vector<V>& v, size_t b, size_t e, size_t p) {
+        const size_t range = e - b;
+        std::cout << "Vec sz " << v.size() << ": [" << b << ".." << e << ") " << range << ", p " << p << ": ";
+        for(size_t k=0; k<v.size(); ++k) {
+            std::cout << "[" << k << "] " << v[k] << ", ";
+        }
+        std::cout << std::endl;
+    }
+
+    template<typename V>
+    using VecIterator = typename std::vector<V>::iterator;
+
+    /**
+     * Null instrumentation policy for all qsort variants.
+     *
+     * All operations are empty or plain pass-through inline functions,
+     * i.e. the instrumented qsort compiles to the same code as the uninstrumented one.
+     */
+    struct no_stats {
+        /** Passes through given comparison result `r`. */
+        constexpr bool cmp(bool r) noexcept { return r; }
+
+        /** Swaps both elements. */
+        template<typename V>
+        constexpr void swap(V& a, V& b) noexcept { std::swap(a, b); }
+
+        /** Notifies a relocation of one element, i.e. an insert/erase pair. */
+        constexpr void relocate() noexcept { }
+
+        /** Entering partitioning at given recursion depth, returns a start timestamp. */
+        constexpr uint64_t enter(size_t /*depth*/) noexcept { return 0; }
+
+        /**
+         * Partitioning of `n` elements at given recursion depth has been completed.
+         * @param depth recursion depth
+         * @param t0 start timestamp as returned by enter()
+         * @param n number of partitioned elements
+         * @param largest number of elements of the largest resulting segment
+         */
+        constexpr void partitioned(size_t /*depth*/, uint64_t /*t0*/, size_t /*n*/, size_t /*largest*/) noexcept { }
+    };
+    static_assert(std::is_empty_v<no_stats>);
+
+    /**
+     * Comparator applying projection `proj` on both arguments before invoking comparator `cmp`,
+     * counting each comparison via instrumentation policy `st`.
+     *
+     * Used by all iterator based qsort variants.
+     */
+    template<typename C, typename P, typename S>
+    struct proj_less {
+        C& cmp;
+        P& proj;
+        S& st;
+
+        template<typename A, typename B>
+        constexpr bool operator()(const A& a, const B& b) {
+            return st.cmp( std::invoke(cmp, std::invoke(proj, a), std::invoke(proj, b)) );
+        }
+    };
+
+    /**
+     * Recording instrumentation policy for all qsort variants.
+     *
+     * Counts comparisons, swaps, maximum recursion depth,
+     * a partition balance histogram and the time spent partitioning per recursion depth.
+     */
+    struct sort_stats {
+        /** Number of balance histogram buckets */
+        constexpr static const size_t balance_buckets = 10;
+
+        uint64_t comparisons = 0;
+        uint64_t swaps = 0;
+        size_t max_depth = 0;
+        /**
+         * Partition balance histogram, bucket `i` counts partitionings
+         * whose largest segment covers [i/10 .. (i+1)/10) of the partitioned range.
+         *
+         * Hence a perfect 2-way split lands in bucket 5 and a degenerated one in bucket 9.
+         */
+        uint64_t balance[balance_buckets] = { 0 };
+        /** Nanoseconds spent partitioning per recursion depth, excluding recursion. */
+        std::vector<uint64_t> depth_ns;
+
+        bool cmp(bool r) noexcept { ++comparisons; return r; }
+
+        template<typename V>
+        void swap(V& a, V& b) noexcept { ++swaps; std::swap(a, b); }
+
+        void relocate() noexcept { ++swaps; }
+
+        uint64_t enter(size_t depth) noexcept {
+            max_depth = std::max(max_depth, depth);
+            return now_ns();
+        }
+
+        void partitioned(size_t depth, uint64_t t0, size_t n, size_t largest) {
+            const uint64_t t1 = now_ns();
+            if( depth_ns.size() <= depth ) {
+                depth_ns.resize(depth+1, 0);
+            }
+            depth_ns[depth] += t1 - t0;
+            ++balance[ std::min(balance_buckets-1, ( largest * balance_buckets ) / n) ];
+        }
+
+        /** Returns the number of recorded partitionings, i.e. the sum of the balance histogram. */
+        uint64_t partitionings() const noexcept {
+            uint64_t c = 0;
+            for(uint64_t v : balance) { c += v; }
+            return c;
+        }
+
+        std::string toString() const {
+            std::string s = "cmp " + std::to_string(comparisons) + ", swaps " + std::to_string(swaps) +
+                            ", depth " + std::to_string(max_depth) + ", balance [";
+            for(size_t i=0; i<balance_buckets; ++i) {
+                s.append(std::to_string(balance[i])).append(i+1 < balance_buckets ? ", " : "]");
+            }
+            s.append(", ns/depth [");
+            for(size_t i=0; i<depth_ns.size(); ++i) {
+                s.append(std::to_string(depth_ns[i])).append(i+1 < depth_ns.size() ? ", " : "");
+            }
+            s.append("]");
+            return s;
+        }
+
+      private:
+        static uint64_t now_ns() noexcept {
+            return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count() );
+        }
+    };
+
+    /**
+     * Fixed capacity stack of [b..e) ranges for the iterative qsort variants.
+     *
+     * Pushing the larger segments and continuing with the smallest one,
+     * the stack holds at most 2 * log3(n) entries for 3 segments and log2(n) entries for 2 segments,
+     * i.e. 128 entries suffice for any 64-bit size.
+     */
+    template<typename I>
+    class range_stack {
+      public:
+        constexpr static const size_t capacity = 128;
+
+        constexpr bool empty() const noexcept { return 0 == m_size; }
+        constexpr size_t size() const noexcept { return m_size; }
+
+        /** Pushes range [b..e) if holding at least 2 elements, otherwise it is already sorted. */
+        constexpr void push(I b, I e) noexcept {
+            if( e - b >= 2 ) {
+                assert( m_size < capacity );
+                m_store[m_size++] = { b, e };
+            }
+        }
+        constexpr std::pair<I, I> pop() noexcept {
+            return m_store[--m_size];
+        }
+
+      private:
+        std::array<std::pair<I, I>, capacity> m_store;
+        size_t m_size = 0;
+    };
+
+    /**
+     * Iterative qsort of range [b..e) using given 2-way `partition` function and an explicit range_stack.
+     *
+     * `partition(b, e)` returns the pair { end of left segment, begin of right segment }.
+     *
+     * The larger segment is pushed on the stack, while the smaller segment is processed next,
+     * bounding the stack to log2(n) entries. The stack size is reported as recursion depth to the policy `st`.
+     *
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename S, typename Partition>
+    size_t qsort_iterative_2way(I b, I e, S& st, Partition partition) {
+        range_stack<I> stack;
+        size_t c = 0;
+        while( true ) {
+            while( e - b >= 2 ) {
+                const size_t depth = stack.size();
+                const uint64_t t0 = st.enter(depth);
+                const auto [le, rb] = partition(b, e);
+                st.partitioned(depth, t0, size_t(e - b), size_t(std::max(le - b, e - rb)));
+                ++c;
+                if( le - b < e - rb ) {
+                    stack.push(rb, e); // larger right side
+                    e = le;
+                } else {
+                    stack.push(b, le); // larger left side
+                    b = rb;
+                }
+            }
+            if( stack.empty() ) {
+                return c;
+            }
+            std::tie(b, e) = stack.pop();
+        }
+    }
+
+}
+
+namespace hoare0 {
+
+    using namespace impl_common;
+
+    /**
+     * Hoare quicksort of range [b..e).
+     *
+     * Quicksort by Tony Hoare in 1959, published 1961.
+     *
+     * @tparam V
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param array
+     * @param b left start index, inclusive
+     * @param e right end index, exclusive
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        // Partitioning:
+        // Stick with using references for comparison, no copy
+        size_t l=b;   // left index
+        size_t r=e-1; // right index -> pivot point
+        const V& p = A[b]; // Pivot, ref only
+        while( true ) {
+            // b -> low pivot index
+            while(st.cmp(A[l] < p)) { ++l; }
+
+            while(st.cmp(A[r] > p)) { --r; }
+
+            if(l >= r) {
+                break;
+            }
+            st.swap(A[l], A[r]);
+            ++l; --r; // skip swapped elements, avoids endless loop on duplicates A[l] == p == A[r]
+        }
+        // printVec(array, b, e, pivot);
+        st.partitioned(depth, t0, e - b, std::max(r+1 - b, e - r - 1));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(A, b,   r+1, st, depth+1); // left side of pivot, pivot included
+        c += qsort(A, r+1, e,   st, depth+1); // right side of pivot
+        return c;
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
+        no_stats st;
+        return qsort(A, b, e, st, 0);
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array, 0, array.size());
+    }
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& array, S& st) {
+        return qsort(array, 0, array.size(), st, 0);
+    }
+
+    /**
+     * Hoare partitioning of iterator range [b..e) with at least 2 elements.
+     * @return pair of { end of left segment, begin of right segment }
+     */
+    template<std::random_access_iterator I, typename L, typename S>
+    std::pair<I, I> partition(I b, I e, L& less, S& st) {
+        // Stick with using references for comparison, no copy
+        I l=b;   // left iterator
+        I r=e-1; // right iterator -> pivot point
+        const auto& p = *b; // Pivot, ref only
+        while( true ) {
+            while(less(*l, p)) { ++l; }
+
+            while(less(p, *r)) { --r; }
+
+            if(l >= r) {
+                break;
+            }
+            st.swap(*l, *r);
+            ++l; --r; // skip swapped elements, avoids endless loop on duplicates *l == p == *r
+        }
+        return { r+1, r+1 }; // left side of pivot, pivot included
+    }
+
+    /**
+     * Hoare quicksort of iterator range [b..e), see index based variant above.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp, P proj, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        proj_less<C, P, S> less{cmp, proj, st};
+        const auto [le, rb] = partition(b, e, less, st);
+        st.partitioned(depth, t0, size_t(e - b), size_t(std::max(le - b, e - rb)));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(b,  le, cmp, proj, st, depth+1); // left side
+        c += qsort(rb, e,  cmp, proj, st, depth+1); // right side
+        return c;
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort(b, e, cmp, proj, st, 0);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort(s.begin(), s.end(), cmp, proj);
+    }
+
+    /**
+     * Iterative Hoare quicksort of iterator range [b..e) w/o recursion,
+     * using a fixed capacity stack of at most log2(n) ranges, see qsort_iterative_2way().
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp, P proj, S& st) {
+        proj_less<C, P, S> less{cmp, proj, st};
+        return qsort_iterative_2way(b, e, st, [&](I b_, I e_) { return partition(b_, e_, less, st); });
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort_iterative(b, e, cmp, proj, st);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort_iterative(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort_iterative(s.begin(), s.end(), cmp, proj);
+    }
+    template<typename V>
+    size_t qsort_iterative(std::vector<V>& array) {
+        return qsort_iterative(array.begin(), array.end());
+    }
+}
+
+namespace hoare1 {
+
+    using namespace impl_common;
+
+    /**
+     * Hoare-Sedgewick quicksort of range [b..e).
+     *
+     * Quicksort by Tony Hoare in 1959, published 1961.
+     *
+     * @tparam V
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param array
+     * @param b left start index, inclusive
+     * @param e right end index, exclusive
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        // Partitioning:
+        // Stick with using references for comparison, no copy
+        size_t l=b;   // left index  -> pivot-point
+        size_t r=e-2; // right index
+        const size_t hi = e-1;
+        const V& p = A[hi]; // Pivot, ref only
+        while( true ) {
+            while(st.cmp(A[l] < p)) { ++l; }
+
+            while(r > 0 && st.cmp(A[r] > p)) { --r; }
+
+            // std::cout << ": [" << l << ".." << r << "]" << std::endl;
+
+            if( r > l ) {
+                st.swap(A[l], A[r]);
+                ++l; --r; // skip swapped elements, avoids endless loop on duplicates A[l] == p == A[r]
+            } else {
+                st.swap(A[l], A[hi]); // move pivot to final position
+                break; // done
+            }
+        }
+        // printVec(A, b, e, pivot);
+        st.partitioned(depth, t0, e - b, std::max(l - b, e - l - 1));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(A, b,   l, st, depth+1); // left side of pivot
+        c += qsort(A, l+1, e, st, depth+1); // right side of pivot
+        return c;
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
+        no_stats st;
+        return qsort(A, b, e, st, 0);
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array, 0, array.size());
+    }
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& array, S& st) {
+        return qsort(array, 0, array.size(), st, 0);
+    }
+
+    /**
+     * Hoare-Sedgewick partitioning of iterator range [b..e) with at least 2 elements.
+     * @return pair of { end of left segment, begin of right segment }
+     */
+    template<std::random_access_iterator I, typename L, typename S>
+    std::pair<I, I> partition(I b, I e, L& less, S& st) {
+        // Stick with using references for comparison, no copy
+        I l=b;   // left iterator  -> pivot-point
+        I r=e-2; // right iterator
+        const I hi = e-1;
+        const auto& p = *hi; // Pivot, ref only
+        while( true ) {
+            while(less(*l, p)) { ++l; }
+
+            while(r > b && less(p, *r)) { --r; }
+
+            if( r > l ) {
+                st.swap(*l, *r);
+                ++l; --r; // skip swapped elements, avoids endless loop on duplicates *l == p == *r
+            } else {
+                st.swap(*l, *hi); // move pivot to final position
+                break; // done
+            }
+        }
+        return { l, l+1 }; // ex-pivot
+    }
+
+    /**
+     * Hoare-Sedgewick quicksort of iterator range [b..e), see index based variant above.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp, P proj, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        proj_less<C, P, S> less{cmp, proj, st};
+        const auto [le, rb] = partition(b, e, less, st);
+        st.partitioned(depth, t0, size_t(e - b), size_t(std::max(le - b, e - rb)));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(b,  le, cmp, proj, st, depth+1); // left side
+        c += qsort(rb, e,  cmp, proj, st, depth+1); // right side
+        return c;
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort(b, e, cmp, proj, st, 0);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort(s.begin(), s.end(), cmp, proj);
+    }
+
+    /**
+     * Iterative Hoare-Sedgewick quicksort of iterator range [b..e) w/o recursion,
+     * using a fixed capacity stack of at most log2(n) ranges, see qsort_iterative_2way().
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp, P proj, S& st) {
+        proj_less<C, P, S> less{cmp, proj, st};
+        return qsort_iterative_2way(b, e, st, [&](I b_, I e_) { return partition(b_, e_, less, st); });
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort_iterative(b, e, cmp, proj, st);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort_iterative(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort_iterative(s.begin(), s.end(), cmp, proj);
+    }
+    template<typename V>
+    size_t qsort_iterative(std::vector<V>& array) {
+        return qsort_iterative(array.begin(), array.end());
+    }
+}
+
+namespace lumoto {
+
+    using namespace impl_common;
+
+    /**
+     * Hoare-Lomuto quicksort of range [b..e).
+     *
+     * Quicksort by Tony Hoare in 1959, published 1961.
+     *
+     * @tparam V
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param array
+     * @param b left start index, inclusive
+     * @param e right end index, exclusive
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        // Partitioning:
+        // Stick with using references for comparison, no copy
+        const size_t hi = e - 1;
+        const V& p = A[hi]; // Pivot, ref only
+        size_t l = b; // pivot point
+        for(size_t j = b; j < hi; ++j) {
+            if( st.cmp(A[j] <= p) ) { // pivot value array[hi]
+                st.swap(A[l], A[j]);
+                ++l; // move temp pivot index forward
+            }
+        }
+        st.swap(A[l], A[hi]); // move pivot to final position
+        // printVec(array, b, e, pivot);
+        st.partitioned(depth, t0, e - b, std::max(l - b, e - l - 1));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(A, b,   l, st, depth+1); // left side of pivot
+        c += qsort(A, l+1, e, st, depth+1); // right side of pivot
+        return c;
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
+        no_stats st;
+        return qsort(A, b, e, st, 0);
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array, 0, array.size());
+    }
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& array, S& st) {
+        return qsort(array, 0, array.size(), st, 0);
+    }
+
+    /**
+     * Hoare-Lomuto partitioning of iterator range [b..e) with at least 2 elements.
+     * @return pair of { end of left segment, begin of right segment }
+     */
+    template<std::random_access_iterator I, typename L, typename S>
+    std::pair<I, I> partition(I b, I e, L& less, S& st) {
+        // Stick with using references for comparison, no copy
+        const I hi = e - 1;
+        const auto& p = *hi; // Pivot, ref only
+        I l = b; // pivot point
+        for(I j = b; j < hi; ++j) {
+            if( !less(p, *j) ) { // *j <= pivot value *hi
+                st.swap(*l, *j);
+                ++l; // move temp pivot forward
+            }
+        }
+        st.swap(*l, *hi); // move pivot to final position
+        return { l, l+1 }; // ex-pivot
+    }
+
+    /**
+     * Hoare-Lomuto quicksort of iterator range [b..e), see index based variant above.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp, P proj, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        proj_less<C, P, S> less{cmp, proj, st};
+        const auto [le, rb] = partition(b, e, less, st);
+        st.partitioned(depth, t0, size_t(e - b), size_t(std::max(le - b, e - rb)));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(b,  le, cmp, proj, st, depth+1); // left side
+        c += qsort(rb, e,  cmp, proj, st, depth+1); // right side
+        return c;
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort(b, e, cmp, proj, st, 0);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort(s.begin(), s.end(), cmp, proj);
+    }
+
+    /**
+     * Iterative Hoare-Lomuto quicksort of iterator range [b..e) w/o recursion,
+     * using a fixed capacity stack of at most log2(n) ranges, see qsort_iterative_2way().
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp, P proj, S& st) {
+        proj_less<C, P, S> less{cmp, proj, st};
+        return qsort_iterative_2way(b, e, st, [&](I b_, I e_) { return partition(b_, e_, less, st); });
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort_iterative(b, e, cmp, proj, st);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort_iterative(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort_iterative(s.begin(), s.end(), cmp, proj);
+    }
+    template<typename V>
+    size_t qsort_iterative(std::vector<V>& array) {
+        return qsort_iterative(array.begin(), array.end());
+    }
+}
+
+namespace hoare2 {
+
+    using namespace impl_common;
+
+    /**
+     * Hoare alike quicksort of range [b..e).
+     *
+     * Difference to Hoare's partitioning is using dedicated loops for each side of the pivot
+     * to move the element over to the other side.
+     * It uses a middle index pivot.
+     *
+     * The pivot element is sorted in place and not included in the recursion like
+     * Lumoto and Sedgewick but unlike Hoare.
+     *
+     * Quicksort by Tony Hoare in 1959, published 1961.
+     *
+     * @tparam V
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param array
+     * @param b left start index, inclusive
+     * @param e right end index, exclusive
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        A.reserve( A.size() + 1 );
+        // Partitioning:
+        // Stick with using references for comparison, no copy
+        // size_t l = ( b + e - 1 ) / 2; // pivot point - sum too big?
+        size_t l = b + ( e - 1 - b ) / 2; // pivot point - better, also solved with std::midpoint(b, e-1)
+        for(size_t i = b; i < l; ) {
+            if( st.cmp(A[i] > A[l]) ) {
+                A.insert(A.begin() + e, A[i]);
+                A.erase( A.begin() + i );
+                st.relocate();
+                --l;
+            } else {
+                ++i;
+            }
+        }
+        for(size_t i = l+1; i < e; ) {
+            if( st.cmp(A[i] < A[l]) ) {
+                A.insert(A.begin() + b, A[i]);
+                ++i;
+                ++l;
+                A.erase( A.begin() + i );
+                st.relocate();
+            } else {
+                ++i;
+            }
+        }
+        // printVec(array, b, e, pivot);
+        st.partitioned(depth, t0, e - b, std::max(l - b, e - l - 1));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(A, b,   l, st, depth+1); // left side of pivot
+        c += qsort(A, l+1, e, st, depth+1); // right side of pivot
+        return c;
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
+        no_stats st;
+        return qsort(A, b, e, st, 0);
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array, 0, array.size());
+    }
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& array, S& st) {
+        return qsort(array, 0, array.size(), st, 0);
+    }
+
+    /**
+     * Hoare alike partitioning of iterator range [b..e) with at least 2 elements.
+     * @return pair of { end of left segment, begin of right segment }
+     */
+    template<std::random_access_iterator I, typename L, typename S>
+    std::pair<I, I> partition(I b, I e, L& less, S& st) {
+        I l = b + ( e - 1 - b ) / 2; // pivot point
+        for(I i = b; i < l; ) {
+            if( less(*l, *i) ) {
+                std::rotate(i, i+1, e); // move *i to the end
+                st.relocate();
+                --l;
+            } else {
+                ++i;
+            }
+        }
+        for(I i = l+1; i < e; ++i) {
+            if( less(*i, *l) ) {
+                std::rotate(b, i, i+1); // move *i to the front
+                st.relocate();
+                ++l;
+            }
+        }
+        return { l, l+1 }; // ex-pivot
+    }
+
+    /**
+     * Hoare alike quicksort of iterator range [b..e), see index based variant above.
+     *
+     * Instead of std::vector insert and erase, elements are relocated via std::rotate
+     * within the given range, having the same O(n) cost per relocation.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp, P proj, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        proj_less<C, P, S> less{cmp, proj, st};
+        const auto [le, rb] = partition(b, e, less, st);
+        st.partitioned(depth, t0, size_t(e - b), size_t(std::max(le - b, e - rb)));
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(b,  le, cmp, proj, st, depth+1); // left side
+        c += qsort(rb, e,  cmp, proj, st, depth+1); // right side
+        return c;
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort(b, e, cmp, proj, st, 0);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort(s.begin(), s.end(), cmp, proj);
+    }
+
+    /**
+     * Iterative Hoare alike quicksort of iterator range [b..e) w/o recursion,
+     * using a fixed capacity stack of at most log2(n) ranges, see qsort_iterative_2way().
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp, P proj, S& st) {
+        proj_less<C, P, S> less{cmp, proj, st};
+        return qsort_iterative_2way(b, e, st, [&](I b_, I e_) { return partition(b_, e_, less, st); });
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort_iterative(b, e, cmp, proj, st);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort_iterative(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort_iterative(s.begin(), s.end(), cmp, proj);
+    }
+    template<typename V>
+    size_t qsort_iterative(std::vector<V>& array) {
+        return qsort_iterative(array.begin(), array.end());
+    }
+}
+
+namespace hoare3 {
+
+    using namespace impl_common;
+
+    /**
+     * Hoare-Yaroslavskiy dual-pivot quicksort of range [b..e).
+     *
+     * Quicksort by Tony Hoare in 1959, published 1961.
+     *
+     * @tparam V
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param array
+     * @param b left start index, inclusive
+     * @param e right end index, exclusive
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        // Partitioning:
+        // Stick with using references for comparison, no copy
+        const size_t hi = e-1;
+        size_t l = b + 1, g = hi - 1; // pivot points
+        {
+            if( st.cmp(A[b] > A[hi]) ) {
+                st.swap(A[b], A[hi]);
+            }
+            const V& p = A[b];  // Pivot 1, ref only
+            const V& q = A[hi]; // Pivot 2, ref only
+            size_t k = l;
+            while (k <= g) {
+                if (st.cmp(A[k] < p)) {
+                    st.swap(A[k], A[l]); ++l;
+                } else if( st.cmp(A[k] >= q) ) {
+                    while( st.cmp(A[g] > q) && k < g ) {
+                     --g;
+                    }
+                    st.swap(A[k], A[g]); --g;
+                    if( st.cmp(A[k] < p) ) {
+                        st.swap(A[k], A[l]); ++l;
+                    }
+                }
+                ++k;
+            }
+            --l; ++g;
+            st.swap(A[b],  A[l]);
+            st.swap(A[hi], A[g]);
+        }
+        st.partitioned(depth, t0, e - b, std::max(std::max(l - b, g - l - 1), e - g - 1));
+
+        // Recursion
+        size_t c = 1;
+        c += qsort(A, b,   l, st, depth+1); // 1st segment, ex-pivot
+        c += qsort(A, l+1, g, st, depth+1); // 2nd segment, ex-pivot
+        c += qsort(A, g+1, e, st, depth+1); // 3rd segment, ex-pivot
+        return c;
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
+        no_stats st;
+        return qsort(A, b, e, st, 0);
+    }
+    template<typename V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array, 0, array.size());
+    }
+    template<typename V, typename S>
+    size_t qsort(std::vector<V>& array, S& st) {
+        return qsort(array, 0, array.size(), st, 0);
+    }
+
+    /**
+     * Hoare-Yaroslavskiy dual-pivot partitioning of iterator range [b..e) with at least 2 elements.
+     * @return pair of both final pivot positions { l, g }, i.e. segments [b..l), [l+1..g) and [g+1..e)
+     */
+    template<std::random_access_iterator I, typename L, typename S>
+    std::pair<I, I> partition(I b, I e, L& less, S& st) {
+        // Stick with using references for comparison, no copy
+        const I hi = e-1;
+        I l = b + 1, g = hi - 1; // pivot points
+        if( less(*hi, *b) ) {
+            st.swap(*b, *hi);
+        }
+        const auto& p = *b;  // Pivot 1, ref only
+        const auto& q = *hi; // Pivot 2, ref only
+        I k = l;
+        while (k <= g) {
+            if (less(*k, p)) {
+                st.swap(*k, *l); ++l;
+            } else if( !less(*k, q) ) {
+                while( less(q, *g) && k < g ) {
+                 --g;
+                }
+                st.swap(*k, *g); --g;
+                if( less(*k, p) ) {
+                    st.swap(*k, *l); ++l;
+                }
+            }
+            ++k;
+        }
+        --l; ++g;
+        st.swap(*b,  *l);
+        st.swap(*hi, *g);
+        return { l, g };
+    }
+
+    /**
+     * Hoare-Yaroslavskiy dual-pivot quicksort of iterator range [b..e), see index based variant above.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @param depth recursion depth
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp, P proj, S& st, size_t depth) {
+        if( e - b < 2 ) {
+            return 0;
+        }
+        const uint64_t t0 = st.enter(depth);
+        proj_less<C, P, S> less{cmp, proj, st};
+        const auto [l, g] = partition(b, e, less, st);
+        st.partitioned(depth, t0, size_t(e - b), size_t(std::max(std::max(l - b, g - l - 1), e - g - 1)));
+
+        // Recursion
+        size_t c = 1;
+        c += qsort(b,   l, cmp, proj, st, depth+1); // 1st segment, ex-pivot
+        c += qsort(l+1, g, cmp, proj, st, depth+1); // 2nd segment, ex-pivot
+        c += qsort(g+1, e, cmp, proj, st, depth+1); // 3rd segment, ex-pivot
+        return c;
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort(b, e, cmp, proj, st, 0);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort(s.begin(), s.end(), cmp, proj);
+    }
+
+    /**
+     * Iterative Hoare-Yaroslavskiy dual-pivot quicksort of iterator range [b..e) w/o recursion,
+     * using a fixed capacity stack of at most 2 * log3(n) ranges.
+     *
+     * Both larger segments are pushed on the stack, while the smallest segment is processed next.
+     * The stack size is reported as recursion depth to the policy `st`.
+     *
+     * @tparam I random access iterator
+     * @tparam C comparator, defaults to std::ranges::less
+     * @tparam P projection, defaults to std::identity
+     * @tparam S instrumentation policy, see no_stats and sort_stats
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param cmp comparator applied to projected elements
+     * @param proj projection applied to each element before comparison
+     * @param st instrumentation policy instance
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I, typename C, typename P, typename S>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp, P proj, S& st) {
+        proj_less<C, P, S> less{cmp, proj, st};
+        range_stack<I> stack;
+        size_t c = 0;
+        while( true ) {
+            while( e - b >= 2 ) {
+                const size_t depth = stack.size();
+                const uint64_t t0 = st.enter(depth);
+                const auto [l, g] = partition(b, e, less, st);
+                st.partitioned(depth, t0, size_t(e - b), size_t(std::max(std::max(l - b, g - l - 1), e - g - 1)));
+                ++c;
+                std::pair<I, I> seg[3] = { { b, l }, { l+1, g }, { g+1, e } };
+                std::sort(std::begin(seg), std::end(seg), [](const std::pair<I, I>& x, const std::pair<I, I>& y) {
+                    return x.second - x.first > y.second - y.first; });
+                stack.push(seg[0].first, seg[0].second); // largest
+                stack.push(seg[1].first, seg[1].second);
+                std::tie(b, e) = seg[2];                 // smallest
+            }
+            if( stack.empty() ) {
+                return c;
+            }
+            std::tie(b, e) = stack.pop();
+        }
+    }
+    template<std::random_access_iterator I, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<I, C, P>
+    size_t qsort_iterative(I b, I e, C cmp = {}, P proj = {}) {
+        no_stats st;
+        return qsort_iterative(b, e, cmp, proj, st);
+    }
+    template<typename V, typename C = std::ranges::less, typename P = std::identity>
+        requires std::sortable<typename std::span<V>::iterator, C, P>
+    size_t qsort_iterative(std::span<V> s, C cmp = {}, P proj = {}) {
+        return qsort_iterative(s.begin(), s.end(), cmp, proj);
+    }
+    template<typename V>
+    size_t qsort_iterative(std::vector<V>& array) {
+        return qsort_iterative(array.begin(), array.end());
+    }
+}
+
+namespace multikey {
+
+    using namespace impl_common;
+
+    /** Concept of a string-like type, i.e. viewable as std::string_view */
+    template<typename T>
+    concept string_like = std::convertible_to<const T&, std::string_view>;
+
+    /**
+     * Returns the character of `s` at position `d` shifted by one,
+     * or 0 for the end of string, i.e. shorter strings sort first.
+     */
+    template<string_like T>
+    constexpr uint16_t char_at(const T& s, size_t d) noexcept {
+        const std::string_view sv(s);
+        return d < sv.size() ? uint16_t( static_cast<unsigned char>(sv[d]) + 1 ) : 0;
+    }
+
+    /** Below this range size, insertion sort is used for the remaining suffixes */
+    constexpr static const size_t insertion_sort_max = 16;
+
+    /**
+     * Insertion sort of range [b..e) comparing the suffixes starting at position `d`,
+     * with all strings sharing the same prefix [0..d).
+     */
+    template<std::random_access_iterator I>
+    void insertion_sort(I b, I e, size_t d) {
+        for(I i = b + 1; i < e; ++i) {
+            for(I j = i; j > b && std::string_view(*j).substr(d) < std::string_view(*(j-1)).substr(d); --j) {
+                std::swap(*j, *(j-1));
+            }
+        }
+    }
+
+    /**
+     * Bentley-Sedgewick multikey (three-way radix) quicksort of range [b..e) at character position `d`.
+     *
+     * All strings of the range share the same prefix [0..d).
+     * Range is partitioned by its character at position `d` in less, equal and greater segments,
+     * where only the equal segment proceeds to the next character position `d+1`.
+     *
+     * The characters at position `d` are cached in `cache`, aligned with [b..e)
+     * and swapped along with the strings. Hence each string's character is loaded only once per position,
+     * and the less and greater segments reuse the cache as they stay at position `d`.
+     *
+     * @tparam I random access iterator of a string_like value type
+     * @param b left start iterator, inclusive
+     * @param e right end iterator, exclusive
+     * @param d character position, i.e. length of the common prefix
+     * @param cache characters at position `d` of range [b..e)
+     * @param cache_valid true if `cache` already holds the characters at position `d`
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I>
+        requires string_like<std::iter_value_t<I>>
+    size_t qsort(I b, I e, size_t d, uint16_t* cache, bool cache_valid) {
+        const size_t n = size_t(e - b);
+        if( n < 2 ) {
+            return 0;
+        }
+        if( n <= insertion_sort_max ) {
+            insertion_sort(b, e, d);
+            return 0;
+        }
+        if( !cache_valid ) {
+            for(size_t i=0; i<n; ++i) {
+                cache[i] = char_at(*(b + i), d);
+            }
+        }
+        // Median of three pivot character
+        const uint16_t c0 = cache[0], c1 = cache[n/2], c2 = cache[n-1];
+        const uint16_t v = std::max(std::min(c0, c1), std::min(std::max(c0, c1), c2));
+
+        // Three-way partitioning (Dijkstra): [0..lt) < v, [lt..gt) == v, [gt..n) > v
+        size_t lt = 0, gt = n, i = 0;
+        while( i < gt ) {
+            const uint16_t c = cache[i];
+            if( c < v ) {
+                std::swap(*(b + i), *(b + lt)); std::swap(cache[i], cache[lt]);
+                ++lt; ++i;
+            } else if( c > v ) {
+                --gt;
+                std::swap(*(b + i), *(b + gt)); std::swap(cache[i], cache[gt]);
+            } else {
+                ++i;
+            }
+        }
+
+        // Recursion:
+        size_t c = 1;
+        c += qsort(b,      b + lt, d,   cache,      true);  // less, same position
+        if( 0 != v ) {                                       // equal, next position unless end of string
+            c += qsort(b + lt, b + gt, d+1, cache + lt, false);
+        }
+        c += qsort(b + gt, e,      d,   cache + gt, true);  // greater, same position
+        return c;
+    }
+
+    /**
+     * Multikey quicksort of range [b..e) of string_like elements in lexicographical order.
+     * @return number of partitioning
+     */
+    template<std::random_access_iterator I>
+        requires string_like<std::iter_value_t<I>>
+    size_t qsort(I b, I e) {
+        std::vector<uint16_t> cache(size_t(e - b));
+        return qsort(b, e, 0, cache.data(), false);
+    }
+    template<string_like V>
+    size_t qsort(std::span<V> s) {
+        return qsort(s.begin(), s.end());
+    }
+    template<string_like V>
+    size_t qsort(std::vector<V>& array) {
+        return qsort(array.begin(), array.end());
+    }
+}
+
+#endif /* CPP_BASICS_QSORT_HPP_ */
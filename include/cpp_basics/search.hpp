@@ -0,0 +1,932 @@
+//============================================================================
+// Author      : Svenson Han Göthel and Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Binary search algorithms on sorted arrays
+//============================================================================
+
+#ifndef CPP_BASICS_SEARCH_HPP_
+#define CPP_BASICS_SEARCH_HPP_
+
+#include <cstddef>
+#include <sys/types.h>
+#include <cassert>
+#include <vector>
+#include <span>
+
+#include <limits>
+#include <bit>
+#include <algorithm>
+#include <type_traits>
+#include <concepts>
+#include <functional>
+#include <ranges>
+#include <utility>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+constexpr static const size_t no_index = std::numeric_limits<size_t>::max();
+
+//
+// compile-time trace policy of the search loops, see binary_search00(), binary_search10() and binary_search11()
+//
+
+/** One probe of a search loop: loop count `c`, range `[l..h]` and probed index `i` */
+struct search_probe {
+    size_t c, l, h, i;
+};
+
+/**
+ * Trace policy discarding all probes.
+ *
+ * The empty inline probe() compiles out completely,
+ * i.e. a search using no_trace generates the same code as an untraced search.
+ */
+struct no_trace {
+    constexpr void probe(size_t, size_t, size_t, size_t) const noexcept { }
+};
+static_assert(std::is_empty_v<no_trace>);
+
+/**
+ * Trace policy recording the last `N` probes into a preallocated ring buffer,
+ * i.e. w/o any allocation or I/O within the search loop.
+ *
+ * @tparam N ring buffer capacity, a power of two
+ */
+template<size_t N>
+class ring_trace {
+  private:
+    static_assert(0 < N && std::has_single_bit(N));
+    search_probe m_probes[N];
+    size_t m_count = 0;
+
+  public:
+    void probe(size_t c, size_t l, size_t h, size_t i) noexcept {
+        m_probes[m_count++ & ( N - 1 )] = { c, l, h, i };
+    }
+
+    /** Returns the number of probes recorded since the last clear(), including overwritten ones. */
+    size_t count() const noexcept { return m_count; }
+
+    /** Returns the number of retained probes, i.e. at most `N`. */
+    size_t size() const noexcept { return std::min(m_count, N); }
+
+    /** Returns the `k`-th oldest retained probe, `k` in range [0..size()). */
+    const search_probe& operator[](size_t k) const noexcept { return m_probes[( m_count - size() + k ) & ( N - 1 )]; }
+
+    void clear() noexcept { m_count = 0; }
+};
+
+//
+// naive implementation halving array value space using ssize_t with negative indices
+//
+constexpr static const ssize_t no_index_0 = -1;
+
+template<typename Trace>
+ssize_t binary_search00(const std::vector<int>& array, int target_value, Trace& trace) {
+    // Because std::vector<>::begin() iterator performs arithmetic
+    // using a signed difference_type, we need to use such a signed type
+    // here to avoid `bugprone-narrowing-conversions` (LINT)
+    //
+    // Now, isn't this odd as std::vector<>::size() uses unsigned size_type,
+    // aka size_t and mentioned iterator hence lose half the value range possible?
+    typedef std::vector<int>::difference_type iterdiff_t;
+    iterdiff_t l = 0;
+    iterdiff_t h = array.cend() - array.cbegin() - 1;
+    iterdiff_t c = 0;
+    while( l <= h ) {
+        // iterdiff_t i = ( l + h ) / 2; // l+h too big?
+        iterdiff_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
+        trace.probe(size_t(c), size_t(l), size_t(h), size_t(i));
+        if ( array[i] < target_value ) {
+            l = i + 1;
+        } else if ( array[i] > target_value ) {
+            h = i - 1;
+        } else {
+            return i;
+        }
+        ++c;
+    }
+    return no_index_0;
+}
+inline ssize_t binary_search00(const std::vector<int>& array, int target_value) {
+    no_trace trace;
+    return binary_search00(array, target_value, trace);
+}
+
+//
+// full array value space using size_t, but additional limit check avoiding underflow,
+// returning no_index if not found
+//
+
+template<typename Trace>
+size_t binary_search10(const std::vector<int>& array, int target_value, Trace& trace) {
+    size_t l = 0;
+    size_t h = array.size()-1;
+    size_t c = 0;
+    while( l <= h ) {
+        // size_t i = ( l + h ) / 2; // l+h too big?
+        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
+        trace.probe(c, l, h, i);
+        if ( array[i] < target_value ) {
+            l = i + 1;
+        } else if ( array[i] > target_value ) {
+            if( i == 0 ) {
+                return no_index;
+            }
+            h = i - 1;
+        } else {
+            return i;
+        }
+        ++c;
+    }
+    return no_index;
+}
+inline size_t binary_search10(const std::vector<int>& array, int target_value) {
+    no_trace trace;
+    return binary_search10(array, target_value, trace);
+}
+
+//
+// full array value space using size_t, excluding lower and upper bounds initially
+//
+
+template<typename Trace>
+size_t binary_search11(const std::vector<int>& array, int target_value, Trace& trace) {
+    size_t l = 0;
+    size_t h = array.size()-1;
+    if ( array[l] == target_value ) {
+        return l;
+    } else if ( array[h] == target_value ) {
+        return h;
+    }
+    size_t c = 0;
+    while( h - l >= 2 ) {
+        // size_t i = ( l + h ) / 2; // l+h too big?
+        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
+        trace.probe(c, l, h, i);
+        if ( array[i] < target_value ) {
+            l = i;
+        } else if ( array[i] > target_value ) {
+            h = i;
+        } else {
+            return i;
+        }
+        ++c;
+    }
+    return no_index;
+}
+inline size_t binary_search11(const std::vector<int>& array, int target_value) {
+    no_trace trace;
+    return binary_search11(array, target_value, trace);
+}
+
+//
+// full array value space using size_t, excluding lower and upper bounds initially,
+// same as binary_search11() w/o trace
+//
+inline size_t binary_search(const std::vector<int>& array, int target_value) {
+    size_t l = 0;
+    size_t h = array.size()-1;
+    if ( array[l] == target_value ) {
+        return l;
+    } else if ( array[h] == target_value ) {
+        return h;
+    }
+    size_t c = 0;
+    while( h - l >= 2 ) {
+        // size_t i = ( l + h ) / 2; // l+h too big?
+        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
+        // std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
+        if ( array[i] < target_value ) {
+            l = i;
+        } else if ( array[i] > target_value ) {
+            h = i;
+        } else {
+            return i;
+        }
+        ++c;
+    }
+    (void)c;
+    return no_index;
+}
+
+//
+// branchless lower bound, halving the length w/o early exit
+//
+
+/**
+ * Returns the index of the first element not less than `target_value`, or `array.size()` if none exists.
+ *
+ * The search range length is halved in each step w/o comparing for equality
+ * and w/o early exit, i.e. the loop count is always ceil(log2(n)).
+ * The only data dependent operation is the choice of the next base,
+ * which compiles to a conditional move (cmov) instead of a branch.
+ * Hence the branch predictor cannot fail.
+ *
+ * @tparam T element type, comparable via operator<
+ * @param array sorted array
+ * @param target_value the value to search for
+ * @return lower bound index in range [0..n]
+ */
+template<typename T>
+size_t lower_bound_branchless(std::span<const T> array, const T& target_value) {
+    size_t n = array.size();
+    if( 0 == n ) {
+        return 0;
+    }
+    const T* base = array.data();
+    while( n > 1 ) {
+        const size_t half = n / 2;
+        base = base[half] < target_value ? base + half : base; // cmov
+        n -= half;
+    }
+    return size_t( base - array.data() ) + size_t( *base < target_value );
+}
+
+/**
+ * Branchless binary search, see lower_bound_branchless().
+ *
+ * The early exit on equality is replaced by a final equality check of the lower bound.
+ *
+ * @tparam T element type, comparable via operator< and operator==
+ * @param array sorted array
+ * @param target_value the value to search for
+ * @return index of the first element equal to `target_value`, otherwise no_index
+ */
+template<typename T>
+size_t binary_search_branchless(std::span<const T> array, const T& target_value) {
+    const size_t i = lower_bound_branchless(array, target_value);
+    return i < array.size() && array[i] == target_value ? i : no_index;
+}
+template<typename T>
+size_t binary_search_branchless(const std::vector<T>& array, const T& target_value) {
+    return binary_search_branchless(std::span<const T>(array), target_value);
+}
+
+/**
+ * Batched lower bound of many target values, see lower_bound_branchless().
+ *
+ * A single search stalls on each probe, as the next probe depends on the current compare.
+ * Here `lanes` searches are advanced in lock-step over the same sequence of range lengths,
+ * where both possible probes of the next level are prefetched for all lanes before comparing the current level.
+ * Hence up to `lanes` independent memory accesses are in flight, hiding the memory latency on large arrays.
+ *
+ * @tparam T element type, comparable via operator<
+ * @tparam lanes number of searches advanced in lock-step
+ * @param array sorted array
+ * @param targets the values to search for
+ * @param results receiving the lower bound index in range [0..n] for each target, same size as `targets`
+ */
+template<typename T, size_t lanes=16>
+void lower_bound_batch(std::span<const T> array, std::span<const T> targets, std::span<size_t> results) {
+    assert( targets.size() == results.size() );
+    const T* const data = array.data();
+    const T* base[lanes];
+    for(size_t q=0; q<targets.size(); q+=lanes) {
+        const size_t m = std::min(lanes, targets.size() - q);
+        const T* const t = targets.data() + q;
+        size_t n = array.size();
+        if( 0 == n ) {
+            std::fill_n(results.data() + q, m, 0);
+            continue;
+        }
+        for(size_t l=0; l<m; ++l) {
+            base[l] = data;
+        }
+        while( n > 1 ) {
+            const size_t half = n / 2;
+            const size_t next_half = ( n - half ) / 2;
+            for(size_t l=0; l<m; ++l) {
+                __builtin_prefetch(base[l] + next_half);
+                __builtin_prefetch(base[l] + half + next_half);
+            }
+            for(size_t l=0; l<m; ++l) {
+                base[l] = base[l][half] < t[l] ? base[l] + half : base[l]; // cmov
+            }
+            n -= half;
+        }
+        for(size_t l=0; l<m; ++l) {
+            results[q+l] = size_t( base[l] - data ) + size_t( *base[l] < t[l] );
+        }
+    }
+}
+
+/**
+ * Batched binary search of many target values, see lower_bound_batch().
+ *
+ * @tparam T element type, comparable via operator< and operator==
+ * @tparam lanes number of searches advanced in lock-step
+ * @param array sorted array
+ * @param targets the values to search for
+ * @param results receiving the index of the first element equal to each target, otherwise no_index; same size as `targets`
+ */
+template<typename T, size_t lanes=16>
+void binary_search_batch(std::span<const T> array, std::span<const T> targets, std::span<size_t> results) {
+    lower_bound_batch<T, lanes>(array, targets, results);
+    for(size_t q=0; q<targets.size(); ++q) {
+        const size_t i = results[q];
+        results[q] = i < array.size() && array[i] == targets[q] ? i : no_index;
+    }
+}
+template<typename T, size_t lanes=16>
+void binary_search_batch(const std::vector<T>& array, const std::vector<T>& targets, std::vector<size_t>& results) {
+    results.resize(targets.size());
+    binary_search_batch<T, lanes>(std::span<const T>(array), std::span<const T>(targets), std::span<size_t>(results));
+}
+
+//
+// interpolation and exponential (galloping) search
+//
+
+/**
+ * Returns the index of the first element not less than `target_value`, or `array.size()` if none exists,
+ * probing the position interpolated linearly between the current range's first and last value.
+ *
+ * Uniformly distributed keys require O(log log n) probes.
+ * Whenever a probe fails to halve the range, e.g. on skewed keys, the next probe bisects the range,
+ * limiting the worst case to O(log n) probes.
+ *
+ * @tparam T arithmetic element type
+ * @param array sorted array
+ * @param target_value the value to search for
+ * @return lower bound index in range [0..n]
+ */
+template<typename T>
+requires std::is_arithmetic_v<T>
+size_t lower_bound_interpolation(std::span<const T> array, const T& target_value) {
+    const size_t n = array.size();
+    if( 0 == n || !( array[0] < target_value ) ) {
+        return 0;
+    } else if( array[n-1] < target_value ) {
+        return n;
+    }
+    // lower bound within ]l..h], keeping the bounding values to load only one probe per step
+    size_t l = 0, h = n-1;
+    double lo = double(array[l]), hi = double(array[h]); // lo < target_value <= hi
+    bool bisect = false;
+    while( h - l > 1 ) {
+        size_t i;
+        // distinct keys may convert to equal doubles, e.g. 64-bit integers above 2^53
+        const double f = hi > lo ? ( double(target_value) - lo ) / ( hi - lo ) : 0.0;
+        if( bisect || !( hi > lo ) || !std::isfinite(f) ) {
+            i = l + ( h - l ) / 2;
+        } else {
+            i = std::clamp(l + size_t( std::clamp(f, 0.0, 1.0) * double(h - l) ), l + 1, h - 1);
+        }
+        const size_t range = h - l;
+        const T& v = array[i];
+        if( v < target_value ) {
+            l = i;
+            lo = double(v);
+        } else {
+            h = i;
+            hi = double(v);
+        }
+        bisect = h - l > range / 2;
+    }
+    return h;
+}
+
+/**
+ * Interpolation search, see lower_bound_interpolation().
+ *
+ * @return index of the first element equal to `target_value`, otherwise no_index
+ */
+template<typename T>
+requires std::is_arithmetic_v<T>
+size_t binary_search_interpolation(std::span<const T> array, const T& target_value) {
+    const size_t i = lower_bound_interpolation(array, target_value);
+    return i < array.size() && array[i] == target_value ? i : no_index;
+}
+template<typename T>
+requires std::is_arithmetic_v<T>
+size_t binary_search_interpolation(const std::vector<T>& array, const T& target_value) {
+    return binary_search_interpolation(std::span<const T>(array), target_value);
+}
+
+/**
+ * Returns the index of the first element not less than `target_value`, or `array.size()` if none exists,
+ * galloping from the given `hint` position.
+ *
+ * The distance to the hint is doubled until the target value is enclosed,
+ * followed by a lower_bound_branchless() within the enclosed range.
+ * For a lower bound `d` positions away from the hint this requires O(log d) probes,
+ * i.e. searches near a known previous position are faster than a full binary search.
+ *
+ * @tparam T element type, comparable via operator<
+ * @param array sorted array
+ * @param target_value the value to search for
+ * @param hint position to start from, clipped to the array
+ * @return lower bound index in range [0..n]
+ */
+template<typename T>
+size_t lower_bound_exponential(std::span<const T> array, const T& target_value, size_t hint) {
+    const size_t n = array.size();
+    if( 0 == n ) {
+        return 0;
+    }
+    hint = std::min(hint, n-1);
+    // lower bound within [l..h]
+    size_t l, h;
+    size_t step = 1;
+    if( array[hint] < target_value ) {
+        l = hint + 1;
+        h = hint + step;
+        while( h < n && array[h] < target_value ) {
+            l = h + 1;
+            step *= 2;
+            h = hint + step;
+        }
+        h = std::min(h, n);
+    } else {
+        h = hint;
+        while( step <= hint && !( array[hint - step] < target_value ) ) {
+            h = hint - step;
+            step *= 2;
+        }
+        l = step <= hint ? hint - step + 1 : 0;
+    }
+    return l + lower_bound_branchless(array.subspan(l, h - l), target_value);
+}
+
+/**
+ * Exponential search from given `hint` position, see lower_bound_exponential().
+ *
+ * @return index of the first element equal to `target_value`, otherwise no_index
+ */
+template<typename T>
+size_t binary_search_exponential(std::span<const T> array, const T& target_value, size_t hint) {
+    const size_t i = lower_bound_exponential(array, target_value, hint);
+    return i < array.size() && array[i] == target_value ? i : no_index;
+}
+template<typename T>
+size_t binary_search_exponential(const std::vector<T>& array, const T& target_value, size_t hint) {
+    return binary_search_exponential(std::span<const T>(array), target_value, hint);
+}
+
+/**
+ * Adaptive search on a sorted array, picking the search mode per lookup.
+ *
+ * The key distribution is sampled once at construction,
+ * considered uniform if the sampled keys deviate at most n/32 positions from their linearly interpolated position.
+ *
+ * Each lookup picks its mode as follows
+ * - exponential, if a hint is given and is near, see lower_bound_exponential().
+ *   For uniform keys the distance `d` to the hint is estimated and considered near if `d^2 <= n`,
+ *   i.e. its 2 log2(d) probes don't exceed a binary search while staying local.
+ *   Otherwise the hint is trusted to be near.
+ * - interpolation, if keys are uniform and the array has at least interpolation_min_size elements,
+ *   see lower_bound_interpolation(). Its fewer probes only pay off if they miss the cache,
+ *   as each probe costs a division and a likely mispredicted branch.
+ * - binary otherwise, see lower_bound_branchless().
+ *
+ * @tparam T arithmetic element type
+ */
+template<typename T>
+requires std::is_arithmetic_v<T>
+class AdaptiveSearch {
+  public:
+    enum class mode { binary, interpolation, exponential };
+
+    /** Minimum number of elements to use interpolation search, i.e. exceeding most caches (8 MiB of `int`) */
+    constexpr static const size_t interpolation_min_size = size_t(1) << 21;
+
+  private:
+    constexpr static const size_t samples = 64;
+
+    std::span<const T> m_array;
+    bool m_uniform;
+
+    static bool is_uniform(std::span<const T> array) noexcept {
+        const size_t n = array.size();
+        if( n < samples || !( array[0] < array[n-1] ) ) {
+            return false;
+        }
+        const double range = double(array[n-1]) - double(array[0]);
+        const double max_dev = double(n) / 32.0;
+        for(size_t k=1; k<samples; ++k) {
+            const size_t i = k * ( n - 1 ) / samples;
+            const double e = ( double(array[i]) - double(array[0]) ) / range * double(n - 1);
+            if( std::abs(e - double(i)) > max_dev ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  public:
+    /**
+     * @param sorted sorted array, referenced and must outlive this instance
+     */
+    AdaptiveSearch(std::span<const T> sorted) noexcept
+    : m_array(sorted), m_uniform(is_uniform(sorted)) {}
+
+    /** Returns true if the sampled keys are considered uniformly distributed. */
+    bool uniform() const noexcept { return m_uniform; }
+
+    /**
+     * Returns the search mode for given target value and hint.
+     * @param target_value the value to search for
+     * @param hint position near the expected result, or no_index if unknown
+     */
+    mode select(const T& target_value, size_t hint=no_index) const noexcept {
+        const size_t n = m_array.size();
+        if( hint < n ) {
+            if( !m_uniform ) {
+                return mode::exponential;
+            }
+            const double range = double(m_array[n-1]) - double(m_array[0]);
+            const double d = std::abs( double(target_value) - double(m_array[hint]) ) / range * double(n - 1);
+            if( d * d <= double(n) ) {
+                return mode::exponential;
+            }
+        }
+        if( m_uniform && n >= interpolation_min_size ) {
+            return mode::interpolation;
+        }
+        return mode::binary;
+    }
+
+    /**
+     * Returns the index of the first element not less than `target_value`, or size() if none exists.
+     * @param target_value the value to search for
+     * @param hint position near the expected result, or no_index if unknown
+     */
+    size_t lower_bound(const T& target_value, size_t hint=no_index) const noexcept {
+        switch( select(target_value, hint) ) {
+            case mode::exponential:   return lower_bound_exponential(m_array, target_value, hint);
+            case mode::interpolation: return lower_bound_interpolation(m_array, target_value);
+            default:                  return lower_bound_branchless(m_array, target_value);
+        }
+    }
+
+    /**
+     * Returns the index of the first element equal to `target_value`, otherwise no_index.
+     * @param target_value the value to search for
+     * @param hint position near the expected result, or no_index if unknown
+     */
+    size_t binary_search(const T& target_value, size_t hint=no_index) const noexcept {
+        const size_t i = lower_bound(target_value, hint);
+        return i < m_array.size() && m_array[i] == target_value ? i : no_index;
+    }
+
+    /** Returns the number of elements. */
+    size_t size() const noexcept { return m_array.size(); }
+};
+
+/**
+ * Static search index of a sorted array using the Eytzinger layout.
+ *
+ * Elements are stored in breadth-first order of the implicit binary search tree,
+ * i.e. the children of node `k` are located at `2k` and `2k+1` using a 1-based index.
+ * The first levels are hence kept close together and hot in the cache,
+ * while the descendants of a node are laid out contiguously per level.
+ *
+ * The descendants `prefetch_levels` levels ahead of the current node
+ * occupy `2^prefetch_levels` contiguous elements, which are prefetched while descending,
+ * e.g. 16 `int` elements being one cache line of 64 bytes.
+ *
+ * Each element stores its index within the original sorted array,
+ * allowing search results to be mapped back using the `size_t` / no_index contract.
+ *
+ * @tparam T element type, comparable via operator< and operator==
+ */
+template<typename T>
+class EytzingerIndex {
+  public:
+    /** Number of tree levels prefetched ahead while descending */
+    constexpr static const size_t prefetch_levels = 4;
+
+  private:
+    constexpr static const size_t prefetch_stride = size_t(1) << prefetch_levels;
+
+    /** elements in Eytzinger order, 1-based w/ unused [0] */
+    std::vector<T> m_data;
+    /** sorted array index of each element, [0] holds size() for a missing lower bound */
+    std::vector<size_t> m_index;
+
+    size_t build(const std::span<const T>& sorted, size_t i, size_t k) {
+        if( k < m_data.size() ) {
+            i = build(sorted, i, 2*k);
+            m_data[k] = sorted[i];
+            m_index[k] = i++;
+            i = build(sorted, i, 2*k+1);
+        }
+        return i;
+    }
+
+    /** Returns the Eytzinger position of the lower bound or 0 if none exists. */
+    size_t lower_bound_pos(const T& target_value) const noexcept {
+        const T* data = m_data.data();
+        const size_t n = m_data.size() - 1;
+        size_t k = 1;
+        while( k <= n ) {
+            __builtin_prefetch(data + k * prefetch_stride);
+            k = 2*k + size_t( data[k] < target_value ); // cmov
+        }
+        // k's path went right, then left at the lower bound: drop trailing ones and the left turn
+        return k >> ( std::countr_one(k) + 1 );
+    }
+
+  public:
+    /**
+     * Builds the index from the given sorted array.
+     * @param sorted sorted array, may contain duplicates
+     */
+    EytzingerIndex(std::span<const T> sorted)
+    : m_data(sorted.size()+1), m_index(sorted.size()+1)
+    {
+        m_index[0] = sorted.size();
+        build(sorted, 0, 1);
+    }
+    EytzingerIndex(const std::vector<T>& sorted)
+    : EytzingerIndex(std::span<const T>(sorted)) {}
+
+    /** Returns the number of elements. */
+    size_t size() const noexcept { return m_data.size() - 1; }
+
+    /**
+     * Returns the sorted array index of the first element not less than `target_value`, or size() if none exists.
+     */
+    size_t lower_bound(const T& target_value) const noexcept {
+        return m_index[ lower_bound_pos(target_value) ];
+    }
+
+    /**
+     * Returns the sorted array index of the first element equal to `target_value`, otherwise no_index.
+     */
+    size_t binary_search(const T& target_value) const noexcept {
+        const size_t k = lower_bound_pos(target_value);
+        return 0 < k && m_data[k] == target_value ? m_index[k] : no_index;
+    }
+};
+
+/**
+ * Static B+ tree (S-tree) search index of a sorted `int` array.
+ *
+ * Keys are grouped into nodes of `node_keys` = 16 keys, i.e. one 64 byte cache line,
+ * each node having `node_keys + 1` children.
+ * The bottom layer holds all keys in sorted order, padded to whole nodes,
+ * so the resulting lower bound position directly matches the original sorted array index.
+ * Each upper layer holds the smallest key of each child subtree except the first,
+ * and the layers are stored in one contiguous array without pointers.
+ *
+ * A lookup touches one cache line per layer, i.e. log17(n) instead of log2(n) for binary_search.
+ *
+ * The rank of a target value within a node, the number of keys less than the target,
+ * is determined by one compare over all 16 keys, merged to a bit mask via movemask and counted via popcount.
+ * This uses AVX2 if enabled at compile time (e.g. `-mavx2` or `-march=native`),
+ * otherwise SSE2 on x86_64 or a plain loop.
+ */
+class STreeIndex {
+  public:
+    /** Number of keys per node */
+    constexpr static const size_t node_keys = 16;
+
+  private:
+    struct alignas(64) node_t {
+        int keys[node_keys];
+    };
+    constexpr static const int pad_key = std::numeric_limits<int>::max();
+
+    size_t m_size;
+    /** all layers, starting with the bottom layer at node 0 */
+    std::vector<node_t> m_nodes;
+    /** node offset of each layer within m_nodes, followed by the total node count */
+    std::vector<size_t> m_offset;
+
+    /**
+     * Returns the number of keys less than `target_value` within given node.
+     *
+     * Vectors are loaded via memcpy instead of casting the `int` keys to a vector pointer,
+     * which would increase the required alignment, see -Wcast-align. The aligned node still yields one plain load each.
+     */
+    static size_t rank(const node_t& node, int target_value) noexcept {
+#if defined(__AVX2__)
+        const __m256i x = _mm256_set1_epi32(target_value);
+        __m256i a, b;
+        std::memcpy(&a, node.keys, sizeof(a));
+        std::memcpy(&b, node.keys + 8, sizeof(b));
+        const unsigned mask = unsigned( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32(x, a) ) ) ) |
+                              unsigned( _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32(x, b) ) ) ) << 8;
+        return size_t( std::popcount(mask) );
+#elif defined(__SSE2__)
+        const __m128i x = _mm_set1_epi32(target_value);
+        unsigned mask = 0;
+        for(unsigned i=0; i<4; ++i) {
+            __m128i k;
+            std::memcpy(&k, node.keys + 4*i, sizeof(k));
+            mask |= unsigned( _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpgt_epi32(x, k) ) ) ) << ( 4*i );
+        }
+        return size_t( std::popcount(mask) );
+#else
+        size_t r = 0;
+        for(size_t i=0; i<node_keys; ++i) {
+            r += size_t( node.keys[i] < target_value );
+        }
+        return r;
+#endif
+    }
+
+  public:
+    /**
+     * Builds the index from the given sorted array.
+     * @param sorted sorted array, may contain duplicates
+     */
+    STreeIndex(std::span<const int> sorted)
+    : m_size(sorted.size())
+    {
+        // layer sizes: bottom layer holds all keys, each upper layer one key per child except the first
+        size_t keys = m_size;
+        size_t total = 0;
+        while( true ) {
+            const size_t nodes = std::max<size_t>(1, ( keys + node_keys - 1 ) / node_keys);
+            m_offset.push_back(total);
+            total += nodes;
+            if( 1 == nodes ) {
+                break;
+            }
+            keys = ( nodes + node_keys ) / ( node_keys + 1 ) * node_keys;
+        }
+        m_offset.push_back(total);
+        m_nodes.resize(total);
+
+        for(size_t m=0; m<m_offset[1]; ++m) {
+            for(size_t j=0; j<node_keys; ++j) {
+                const size_t i = m * node_keys + j;
+                m_nodes[m].keys[j] = i < m_size ? sorted[i] : pad_key;
+            }
+        }
+        for(size_t h=1; h<m_offset.size()-1; ++h) {
+            for(size_t m=0; m<m_offset[h+1]-m_offset[h]; ++m) {
+                for(size_t j=0; j<node_keys; ++j) {
+                    // leftmost bottom node of child j+1
+                    size_t c = m * ( node_keys + 1 ) + j + 1;
+                    for(size_t l=1; l<h; ++l) {
+                        c *= node_keys + 1;
+                    }
+                    m_nodes[m_offset[h] + m].keys[j] = c * node_keys < m_size ? sorted[c * node_keys] : pad_key;
+                }
+            }
+        }
+    }
+    STreeIndex(const std::vector<int>& sorted)
+    : STreeIndex(std::span<const int>(sorted)) {}
+
+    /** Returns the number of elements. */
+    size_t size() const noexcept { return m_size; }
+
+    /** Returns the number of layers. */
+    size_t height() const noexcept { return m_offset.size() - 1; }
+
+    /**
+     * Returns the sorted array index of the first element not less than `target_value`, or size() if none exists.
+     */
+    size_t lower_bound(int target_value) const noexcept {
+        size_t k = 0;
+        for(size_t h=height()-1; h>0; --h) {
+            k = k * ( node_keys + 1 ) + rank(m_nodes[m_offset[h] + k], target_value);
+        }
+        return std::min(m_size, k * node_keys + rank(m_nodes[k], target_value));
+    }
+
+    /**
+     * Returns the sorted array index of the first element equal to `target_value`, otherwise no_index.
+     */
+    size_t binary_search(int target_value) const noexcept {
+        const size_t i = lower_bound(target_value);
+        return i < m_size && m_nodes[i / node_keys].keys[i % node_keys] == target_value ? i : no_index;
+    }
+};
+
+/**
+ * Generic typed search API over sorted `std::span<const T>`, using a comparator and projection.
+ *
+ * The comparator `cmp` defines the order of the projected elements `proj(e)` as used for sorting,
+ * defaulting to std::ranges::less and std::identity.
+ * Each function also accepts any contiguous range, e.g. a `std::vector<T>`, which is viewed as such a span.
+ *
+ * All functions return indices, using no_index if not found.
+ * If the projected element type is arithmetic, the branchless halving loop is used,
+ * see lower_bound_branchless(), otherwise a conventional branching halving loop
+ * evaluates an expensive comparison, e.g. of strings, only once per probe instead of twice for a three-way compare.
+ */
+namespace sorted {
+
+    /** Concept of type-trait std::is_arithmetic */
+    template <typename T>
+    concept arithmetic = std::is_arithmetic_v<T>;
+
+    /** Concept of an element type `T` whose projection by `P` is arithmetic, selecting the branchless search. */
+    template <typename T, typename P>
+    concept arithmetic_projection = arithmetic<std::remove_cvref_t<std::invoke_result_t<P&, const T&>>>;
+
+    /** Concept of a contiguous range, viewable as a span */
+    template <typename R>
+    concept span_viewable = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>;
+
+    /**
+     * Returns the index of the first element not satisfying `pred`, with all elements satisfying `pred` preceding all others.
+     * @tparam branchless true to use the branchless halving loop
+     */
+    template<bool branchless, typename T, typename Pred>
+    size_t partition_point(std::span<const T> array, Pred pred) {
+        size_t n = array.size();
+        const T* base = array.data();
+        if constexpr ( branchless ) {
+            if( 0 == n ) {
+                return 0;
+            }
+            while( n > 1 ) {
+                const size_t half = n / 2;
+                base = pred(base[half]) ? base + half : base; // cmov
+                n -= half;
+            }
+            return size_t( base - array.data() ) + size_t( pred(*base) );
+        } else {
+            while( n > 0 ) {
+                const size_t half = n / 2;
+                if( pred(base[half]) ) {
+                    base += half + 1;
+                    n -= half + 1;
+                } else {
+                    n = half;
+                }
+            }
+            return size_t( base - array.data() );
+        }
+    }
+
+    /**
+     * Returns the index of the first element not less than `value`, or `array.size()` if none exists.
+     * @param array sorted array
+     * @param value the projected value to search for
+     * @param cmp comparator of projected elements
+     * @param proj projection of elements
+     */
+    template<typename T, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t lower_bound(std::span<const T> array, const V& value, C cmp={}, P proj={}) {
+        return partition_point<arithmetic_projection<T, P>>(array, [&](const T& e) -> bool {
+            return std::invoke(cmp, std::invoke(proj, e), value); });
+    }
+
+    /**
+     * Returns the index of the first element greater than `value`, or `array.size()` if none exists.
+     * @param array sorted array
+     * @param value the projected value to search for
+     * @param cmp comparator of projected elements
+     * @param proj projection of elements
+     */
+    template<typename T, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t upper_bound(std::span<const T> array, const V& value, C cmp={}, P proj={}) {
+        return partition_point<arithmetic_projection<T, P>>(array, [&](const T& e) -> bool {
+            return !std::invoke(cmp, value, std::invoke(proj, e)); });
+    }
+
+    /**
+     * Returns the index range [first, second) of all elements equal to `value`, see lower_bound() and upper_bound().
+     */
+    template<typename T, typename V, typename C=std::ranges::less, typename P=std::identity>
+    std::pair<size_t, size_t> equal_range(std::span<const T> array, const V& value, C cmp={}, P proj={}) {
+        const size_t l = lower_bound(array, value, cmp, proj);
+        return { l, l + upper_bound(array.subspan(l), value, cmp, proj) };
+    }
+
+    /**
+     * Returns the index of the first element equal to `value`, otherwise no_index.
+     * @param array sorted array
+     * @param value the projected value to search for
+     * @param cmp comparator of projected elements
+     * @param proj projection of elements
+     */
+    template<typename T, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t binary_search(std::span<const T> array, const V& value, C cmp={}, P proj={}) {
+        const size_t i = lower_bound(array, value, cmp, proj);
+        return i < array.size() && !std::invoke(cmp, value, std::invoke(proj, array[i])) ? i : no_index;
+    }
+
+    template<span_viewable R, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t lower_bound(const R& array, const V& value, C cmp={}, P proj={}) {
+        return lower_bound(std::span<const std::ranges::range_value_t<R>>(array), value, cmp, proj);
+    }
+    template<span_viewable R, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t upper_bound(const R& array, const V& value, C cmp={}, P proj={}) {
+        return upper_bound(std::span<const std::ranges::range_value_t<R>>(array), value, cmp, proj);
+    }
+    template<span_viewable R, typename V, typename C=std::ranges::less, typename P=std::identity>
+    std::pair<size_t, size_t> equal_range(const R& array, const V& value, C cmp={}, P proj={}) {
+        return equal_range(std::span<const std::ranges::range_value_t<R>>(array), value, cmp, proj);
+    }
+    template<span_viewable R, typename V, typename C=std::ranges::less, typename P=std::identity>
+    size_t binary_search(const R& array, const V& value, C cmp={}, P proj={}) {
+        return binary_search(std::span<const std::ranges::range_value_t<R>>(array), value, cmp, proj);
+    }
+
+} // namespace sorted
+
+#endif /* CPP_BASICS_SEARCH_HPP_ */
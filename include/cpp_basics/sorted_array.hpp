@@ -0,0 +1,357 @@
+//============================================================================
+// Author      : Svenson Han Göthel and Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Sorted insert and sorted containers
+//============================================================================
+
+#ifndef CPP_BASICS_SORTED_ARRAY_HPP_
+#define CPP_BASICS_SORTED_ARRAY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <span>
+#include <bit>
+
+#include "cpp_basics/search.hpp"
+
+//
+// sorted insert into a plain vector, shifting all following elements
+//
+inline size_t ordered_insert(std::vector<int>& array, int value) {
+    if( array.size() < 1 ) {
+        array.push_back(value);
+        return 0;
+    }
+    // Because std::vector<>::begin() iterator performs arithmetic
+    // using a signed difference_type, we need to use such a signed type
+    // here to avoid `bugprone-narrowing-conversions` (LINT)
+    //
+    // Now, isn't this odd as std::vector<>::size() uses unsigned size_type,
+    // aka size_t and mentioned iterator hence lose half the value range possible?
+    typedef std::vector<int>::difference_type iterdiff_t;
+    iterdiff_t l = 0;
+    iterdiff_t h = array.cend() - array.cbegin() - 1;
+    if ( array[l] >= value ) {
+        array.insert(array.begin(), value);
+        return l;
+    } else if ( array[h] <= value ) {
+        array.insert(array.end(), value);
+        return h+1;
+    }
+    // size_t c = 0;
+    while( h - l >= 2 ) {
+        // iterdiff_t i = ( l + h ) / 2; // l+h too big?
+        iterdiff_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
+        // std::cout << "c " << c << " (" << l << ".." << h << "): p " << i << std::endl;
+        if ( array[i] < value ) {
+            l = i;
+        } else if ( array[i] > value ) {
+            h = i;
+        } else {
+            array.insert(array.begin() + i, value);
+            return i;
+        }
+        // ++c;
+    }
+    array.insert(array.begin() + h, value);
+    return h;
+}
+
+/**
+ * Bulk sorted insert of a batch of unsorted values into the sorted array.
+ *
+ * The batch is sorted first, then merged into the array in a single backward in-place pass,
+ * moving each existing element at most once and reallocating the array at most once.
+ * For n elements and batch size m this costs O(n + m log m) instead of O(n m) using ordered_insert() per value.
+ *
+ * @param array sorted array
+ * @param values batch of unsorted values, passed by value to be sorted in place
+ */
+inline void ordered_insert(std::vector<int>& array, std::vector<int> values) {
+    std::sort(values.begin(), values.end());
+    size_t i = array.size();
+    size_t j = values.size();
+    array.resize(i + j);
+    size_t k = array.size();
+    // fill from the back, where the merged result never overtakes unmerged elements of `array`
+    while( j > 0 ) {
+        if( i > 0 && array[i-1] > values[j-1] ) {
+            array[--k] = array[--i];
+        } else {
+            array[--k] = values[--j];
+        }
+    }
+}
+
+namespace sorted {
+
+    /**
+     * Sorted insert of given value after all equal elements, see cpp_basics/search.hpp.
+     * @param array sorted array
+     * @param value the value to insert
+     * @param cmp comparator of projected elements
+     * @param proj projection of elements
+     * @return index of the inserted value
+     */
+    template<typename T, typename C=std::ranges::less, typename P=std::identity>
+    size_t ordered_insert(std::vector<T>& array, const T& value, C cmp={}, P proj={}) {
+        const size_t i = upper_bound(std::span<const T>(array), std::invoke(proj, value), cmp, proj);
+        array.insert(array.begin() + ptrdiff_t(i), value);
+        return i;
+    }
+
+    /**
+     * Bulk sorted insert of a batch of unsorted values, see ::ordered_insert(std::vector<int>&, std::vector<int>).
+     * @param array sorted array
+     * @param values batch of unsorted values, passed by value to be sorted in place
+     * @param cmp comparator of projected elements
+     * @param proj projection of elements
+     */
+    template<typename T, typename C=std::ranges::less, typename P=std::identity>
+    void ordered_insert(std::vector<T>& array, std::vector<T> values, C cmp={}, P proj={}) {
+        std::ranges::stable_sort(values, cmp, proj);
+        size_t i = array.size();
+        size_t j = values.size();
+        array.resize(i + j);
+        size_t k = array.size();
+        while( j > 0 ) {
+            if( i > 0 && std::invoke(cmp, std::invoke(proj, values[j-1]), std::invoke(proj, array[i-1])) ) {
+                array[--k] = std::move(array[--i]);
+            } else {
+                array[--k] = std::move(values[--j]);
+            }
+        }
+    }
+
+} // namespace sorted
+
+/**
+ * Sorted sequence container using a packed memory array (PMA).
+ *
+ * Elements are kept in order within one contiguous array, with gaps spread throughout.
+ * The array is divided into segments of segment_size() slots, each segment keeping its elements
+ * packed at its beginning. An insert only shifts the elements of its segment,
+ * as long as the segment has a free slot.
+ *
+ * A full segment triggers a rebalance of the smallest enclosing window of 2^l segments,
+ * whose density stays below the window's upper threshold, spreading its elements evenly.
+ * The threshold decreases linearly from 1.0 for a single segment to 0.75 for the whole array.
+ * If even the whole array exceeds its threshold, the capacity is doubled.
+ * The segment size is kept at about log2(capacity), resulting in amortized O(log^2 n) element moves per insert.
+ *
+ * Scans stay sequential over the contiguous array, skipping the gaps at each segment's end.
+ * Lookups use a binary search over the first element of each segment followed by one segment scan.
+ *
+ * All segments are non-empty as long as the container is non-empty,
+ * as rebalancing never spreads fewer elements than segments and elements are never removed.
+ *
+ * @tparam T element type, comparable via operator<
+ */
+template<typename T>
+class PackedMemoryArray {
+  private:
+    constexpr static const size_t min_segment_size = 8;
+    constexpr static const double root_density = 0.75;
+
+    std::vector<T> m_slots;
+    /** element count per segment */
+    std::vector<size_t> m_count;
+    size_t m_segment_size;
+    size_t m_size;
+    /** reused buffer to gather a window's elements during rebalance */
+    std::vector<T> m_buffer;
+
+    size_t segment_count() const noexcept { return m_count.size(); }
+
+    /** Returns the segment to insert `value` into, i.e. the last segment whose first element is not greater than `value`. */
+    size_t find_segment(const T& value) const noexcept {
+        size_t l = 0;
+        size_t n = segment_count();
+        while( n > 1 ) {
+            const size_t half = n / 2;
+            l = value < m_slots[( l + half ) * m_segment_size] ? l : l + half; // cmov
+            n -= half;
+        }
+        return l;
+    }
+
+    /** Upper density threshold of a window at given level, level 0 being a single segment. */
+    double upper_density(size_t level, size_t height) const noexcept {
+        return 0 == height ? root_density : 1.0 - ( 1.0 - root_density ) * double(level) / double(height);
+    }
+
+    /** Gathers the elements of segments [s0..s1) into m_buffer, inserting `value` at its ordered position. */
+    void gather(size_t s0, size_t s1, const T& value) {
+        m_buffer.clear();
+        bool inserted = false;
+        for(size_t s=s0; s<s1; ++s) {
+            T* seg = m_slots.data() + s * m_segment_size;
+            for(size_t i=0; i<m_count[s]; ++i) {
+                if( !inserted && value < seg[i] ) {
+                    m_buffer.push_back(value);
+                    inserted = true;
+                }
+                m_buffer.push_back(std::move(seg[i]));
+            }
+        }
+        if( !inserted ) {
+            m_buffer.push_back(value);
+        }
+    }
+
+    /** Spreads m_buffer evenly over segments [s0..s1). */
+    void spread(size_t s0, size_t s1) {
+        const size_t segments = s1 - s0;
+        const size_t per_segment = m_buffer.size() / segments;
+        const size_t remainder = m_buffer.size() % segments;
+        size_t j = 0;
+        for(size_t s=s0; s<s1; ++s) {
+            const size_t c = per_segment + size_t( s - s0 < remainder );
+            std::move(m_buffer.begin() + j, m_buffer.begin() + j + c, m_slots.begin() + s * m_segment_size);
+            m_count[s] = c;
+            j += c;
+        }
+    }
+
+    /** Rebuilds the whole array with given slot capacity, inserting `value`. */
+    void grow(size_t capacity, const T& value) {
+        gather(0, segment_count(), value);
+        m_segment_size = std::max(min_segment_size, std::bit_ceil( size_t( std::bit_width(capacity) ) ));
+        const size_t segments = std::max<size_t>(1, capacity / m_segment_size);
+        m_slots.assign(segments * m_segment_size, T());
+        m_count.assign(segments, 0);
+        spread(0, segments);
+    }
+
+  public:
+    /**
+     * Forward iterator over all elements in order, skipping the gaps.
+     */
+    class const_iterator {
+      private:
+        friend class PackedMemoryArray;
+        const PackedMemoryArray* m_pma;
+        size_t m_segment;
+        size_t m_offset;
+
+        const_iterator(const PackedMemoryArray* pma, size_t segment, size_t offset) noexcept
+        : m_pma(pma), m_segment(segment), m_offset(offset) { skip_gap(); }
+
+        void skip_gap() noexcept {
+            while( m_segment < m_pma->segment_count() && m_offset == m_pma->m_count[m_segment] ) {
+                ++m_segment;
+                m_offset = 0;
+            }
+        }
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator() noexcept : m_pma(nullptr), m_segment(0), m_offset(0) {}
+
+        reference operator*() const noexcept { return m_pma->m_slots[m_segment * m_pma->m_segment_size + m_offset]; }
+        pointer operator->() const noexcept { return &operator*(); }
+
+        const_iterator& operator++() noexcept { ++m_offset; skip_gap(); return *this; }
+        const_iterator operator++(int) noexcept { const_iterator r = *this; ++*this; return r; }
+
+        bool operator==(const const_iterator& o) const noexcept { return m_segment == o.m_segment && m_offset == o.m_offset; }
+    };
+
+    PackedMemoryArray()
+    : m_slots(min_segment_size), m_count(1, 0), m_segment_size(min_segment_size), m_size(0)
+    { }
+
+    /** Returns the number of elements. */
+    size_t size() const noexcept { return m_size; }
+
+    bool empty() const noexcept { return 0 == m_size; }
+
+    /** Returns the number of slots, i.e. elements and gaps. */
+    size_t capacity() const noexcept { return m_slots.size(); }
+
+    /** Returns the number of slots per segment. */
+    size_t segment_size() const noexcept { return m_segment_size; }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, segment_count(), 0); }
+
+    /**
+     * Inserts given value after all equal elements.
+     * @param value the value to insert
+     */
+    void insert(const T& value) {
+        const size_t s = find_segment(value);
+        if( m_count[s] < m_segment_size ) {
+            T* seg = m_slots.data() + s * m_segment_size;
+            T* pos = std::upper_bound(seg, seg + m_count[s], value);
+            std::move_backward(pos, seg + m_count[s], seg + m_count[s] + 1);
+            *pos = value;
+            ++m_count[s];
+            ++m_size;
+            return;
+        }
+        // find the smallest enclosing window within its density threshold
+        const size_t height = size_t( std::bit_width( segment_count() ) ) - 1;
+        size_t count = m_count[s];
+        for(size_t level=1; level<=height; ++level) {
+            const size_t segments = size_t(1) << level;
+            const size_t s0 = s & ~( segments - 1 );
+            const size_t s1 = s0 + segments;
+            count = 0;
+            for(size_t i=s0; i<s1; ++i) {
+                count += m_count[i];
+            }
+            if( double( count + 1 ) <= upper_density(level, height) * double( segments * m_segment_size ) ) {
+                gather(s0, s1, value);
+                spread(s0, s1);
+                ++m_size;
+                return;
+            }
+        }
+        grow(2 * capacity(), value);
+        ++m_size;
+    }
+
+    /**
+     * Returns an iterator to the first element not less than `value`, or end() if none exists.
+     */
+    const_iterator lower_bound(const T& value) const noexcept {
+        if( 0 == m_size ) {
+            return end();
+        }
+        // last segment whose first element is less than `value`, all prior segments only hold lesser elements
+        size_t l = 0;
+        size_t n = segment_count();
+        while( n > 1 ) {
+            const size_t half = n / 2;
+            l = m_slots[( l + half ) * m_segment_size] < value ? l + half : l; // cmov
+            n -= half;
+        }
+        const T* seg = m_slots.data() + l * m_segment_size;
+        const size_t i = size_t( std::lower_bound(seg, seg + m_count[l], value) - seg );
+        return const_iterator(this, l, i);
+    }
+
+    /**
+     * Returns an iterator to the first element equal to `value`, or end() if none exists.
+     */
+    const_iterator find(const T& value) const noexcept {
+        const const_iterator it = lower_bound(value);
+        return it != end() && !( value < *it ) ? it : end();
+    }
+
+    /** Returns true if an element equal to `value` exists. */
+    bool contains(const T& value) const noexcept { return find(value) != end(); }
+};
+
+#endif /* CPP_BASICS_SORTED_ARRAY_HPP_ */
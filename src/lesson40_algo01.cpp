@@ -14,12 +14,26 @@
 #include <limits>
 #include <cassert>
 
+#include "cpp_basics/search.hpp"
+
 /**
  * Lesson 4.0
  *
  * Implementing binary search on a sorted array
+ *
+ * binary_search00(), binary_search10() and binary_search11() are shared via cpp_basics/search.hpp
+ * using a compile-time trace policy for their probes.
  */
 
+/**
+ * Trace policy printing each probe
+ */
+struct cout_trace {
+    void probe(size_t c, size_t l, size_t h, size_t i) const {
+        std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
+    }
+};
+
 typedef ssize_t (*binary_search_func0_t)(const std::vector<int>& array, int target_value);
 typedef size_t (*binary_search_func1_t)(const std::vector<int>& array, int target_value);
 
@@ -42,95 +56,6 @@ bool test_binsearch1(binary_search_func1_t binary_search, const std::vector<int>
     }
 }
 
-//
-// naive implementation halving array value space using ssize_t with negative indices
-//
-constexpr static const ssize_t no_index_0 = -1;
-
-ssize_t binary_search00(const std::vector<int>& array, int target_value) {
-    // Because std::vector<>::begin() iterator performs arithmetic
-    // using a signed difference_type, we need to use such a signed type
-    // here to avoid `bugprone-narrowing-conversions` (LINT)
-    //
-    // Now, isn't this odd as std::vector<>::size() uses unsigned size_type,
-    // aka size_t and mentioned iterator hence lose half the value range possible?
-    typedef std::vector<int>::difference_type iterdiff_t;
-    iterdiff_t l = 0;
-    iterdiff_t h = array.cend() - array.cbegin() - 1;
-    iterdiff_t c = 0;
-    while( l <= h ) {
-        // iterdiff_t i = ( l + h ) / 2; // l+h too big?
-        iterdiff_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
-        std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
-        if ( array[i] < target_value ) {
-            l = i + 1;
-        } else if ( array[i] > target_value ) {
-            h = i - 1;
-        } else {
-            return i;
-        }
-        ++c;
-    }
-    return no_index_0;
-}
-
-//
-// full array value space using size_t, but additional limit check avoiding underflow
-//
-constexpr static const size_t no_index = std::numeric_limits<size_t>::max();
-
-size_t binary_search10(const std::vector<int>& array, int target_value) {
-    size_t l = 0;
-    size_t h = array.size()-1;
-    size_t c = 0;
-    while( l <= h ) {
-        // size_t i = ( l + h ) / 2; // l+h too big?
-        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
-        std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
-        if ( array[i] < target_value ) {
-            l = i + 1;
-        } else if ( array[i] > target_value ) {
-            if( h == 0 ) {
-                return no_index;
-            }
-            h = i - 1;
-        } else {
-            return i;
-        }
-        ++c;
-    }
-    return no_index;
-}
-
-//
-// full array value space using size_t, excluding lower and upper bounds initially
-//
-
-size_t binary_search11(const std::vector<int>& array, int target_value) {
-    size_t l = 0;
-    size_t h = array.size()-1;
-    if ( array[l] == target_value ) {
-        return l;
-    } else if ( array[h] == target_value ) {
-        return h;
-    }
-    size_t c = 0;
-    while( h - l >= 2 ) {
-        // size_t i = ( l + h ) / 2; // l+h too big?
-        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
-        std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
-        if ( array[i] < target_value ) {
-            l = i;
-        } else if ( array[i] > target_value ) {
-            h = i;
-        } else {
-            return i;
-        }
-        ++c;
-    }
-    return no_index;
-}
-
 void test_binsearch0(binary_search_func0_t binary_search, std::vector<int>& array_in, std::vector<int>& array_miss, int line) {
     // Because std::vector<>::begin() iterator performs arithmetic
     // using a signed difference_type, we need to use such a signed type
@@ -195,18 +120,77 @@ int main(int, const char**) {
 
     // test impl00
     {
+        binary_search_func0_t binary_search00_cout = [](const std::vector<int>& array, int target_value) {
+            cout_trace trace;
+            return binary_search00(array, target_value, trace);
+        };
+        test_binsearch0(binary_search00_cout, array1_in, array1_miss, __LINE__);
+        test_binsearch0(binary_search00_cout, array2_in, array2_miss, __LINE__);
         test_binsearch0(binary_search00, array1_in, array1_miss, __LINE__);
         test_binsearch0(binary_search00, array2_in, array2_miss, __LINE__);
     }
     // test impl10
     {
+        binary_search_func1_t binary_search10_cout = [](const std::vector<int>& array, int target_value) {
+            cout_trace trace;
+            return binary_search10(array, target_value, trace);
+        };
+        test_binsearch1(binary_search10_cout, array1_in, array1_miss, __LINE__);
+        test_binsearch1(binary_search10_cout, array2_in, array2_miss, __LINE__);
         test_binsearch1(binary_search10, array1_in, array1_miss, __LINE__);
         test_binsearch1(binary_search10, array2_in, array2_miss, __LINE__);
     }
     // test impl11
     {
+        binary_search_func1_t binary_search11_cout = [](const std::vector<int>& array, int target_value) {
+            cout_trace trace;
+            return binary_search11(array, target_value, trace);
+        };
+        test_binsearch1(binary_search11_cout, array1_in, array1_miss, __LINE__);
+        test_binsearch1(binary_search11_cout, array2_in, array2_miss, __LINE__);
         test_binsearch1(binary_search11, array1_in, array1_miss, __LINE__);
         test_binsearch1(binary_search11, array2_in, array2_miss, __LINE__);
     }
+    // test ring_trace, recording the last probes w/o I/O
+    {
+        ring_trace<2> trace;
+        const size_t idx = binary_search10(array1_in, 0, trace);
+        assert( 0 == idx );
+        assert( 3 == trace.count() );
+        assert( 2 == trace.size() );
+        for(size_t k=0; k<trace.size(); ++k) {
+            const search_probe& p = trace[k];
+            std::cout << "ring[" << k << "]: c " << p.c << " [" << p.l << ".." << p.h << "]: p " << p.i << std::endl;
+        }
+        assert( 1 == trace[0].c && 1 == trace[0].i );
+        assert( 2 == trace[1].c && idx == trace[1].i );
+    }
+    // test branchless, see cpp_basics/search.hpp
+    {
+        binary_search_func1_t binary_search_bl = [](const std::vector<int>& array, int target_value) {
+            return binary_search_branchless(array, target_value);
+        };
+        test_binsearch1(binary_search_bl, array1_in, array1_miss, __LINE__);
+        test_binsearch1(binary_search_bl, array2_in, array2_miss, __LINE__);
+    }
+    // test interpolation, exponential and adaptive, see cpp_basics/search.hpp
+    {
+        binary_search_func1_t binary_search_ip = [](const std::vector<int>& array, int target_value) {
+            return binary_search_interpolation(array, target_value);
+        };
+        binary_search_func1_t binary_search_exp0 = [](const std::vector<int>& array, int target_value) {
+            return binary_search_exponential(array, target_value, 0);
+        };
+        binary_search_func1_t binary_search_exp1 = [](const std::vector<int>& array, int target_value) {
+            return binary_search_exponential(array, target_value, array.size()-1);
+        };
+        binary_search_func1_t binary_search_ad = [](const std::vector<int>& array, int target_value) {
+            return AdaptiveSearch<int>(array).binary_search(target_value, array.size()/2);
+        };
+        for(binary_search_func1_t f : { binary_search_ip, binary_search_exp0, binary_search_exp1, binary_search_ad }) {
+            test_binsearch1(f, array1_in, array1_miss, __LINE__);
+            test_binsearch1(f, array2_in, array2_miss, __LINE__);
+        }
+    }
     return 0;
 }
@@ -0,0 +1,672 @@
+//============================================================================
+// Author      : Svenson Han Göthel and Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Benchmarking binary search algorithms
+//============================================================================
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <span>
+#include <array>
+#include <functional>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/search.hpp"
+#include "cpp_basics/learned_index.hpp"
+
+/**
+ * Lesson 4.0 Benchmark of binary search variants on sorted arrays.
+ *
+ * Array sizes range from L1 cache resident up to DRAM resident.
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> size <n> queries <q>` and performs `q` lookups,
+ * i.e. the bench-csv ns_per_element column reports ns per lookup, see cpp_basics::BenchCSVListener.
+ */
+namespace bench_env {
+    typedef std::vector<int> vector_t;
+
+    constexpr static const uint32_t seed = 0x1234567;
+
+    /** Number of lookups per benchmark run */
+    constexpr static const size_t query_count = 4096;
+
+    /** Sorted array of `n` even numbers 0, 2, 4, .. */
+    vector_t make_sorted_even(size_t n) {
+        vector_t v(n);
+        for(size_t i=0; i<n; ++i) { v[i] = int(2*i); }
+        return v;
+    }
+
+    /** Random queries on given array of make_sorted_even(), half hits, half misses (odd numbers) */
+    vector_t make_queries(const vector_t& array, size_t q) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> dist(0, array.size()-1);
+        vector_t v(q);
+        for(size_t i=0; i<q; ++i) {
+            v[i] = array[dist(rng)] + int(i & 1);
+        }
+        return v;
+    }
+
+    /** Binary search function returning the index or no_index */
+    typedef size_t (*search_func)(const vector_t& array, int target_value);
+
+    const std::pair<const char*, search_func> variants[] = {
+        { "binary_search00", [](const vector_t& a, int t) { const ssize_t i = binary_search00(a, t); return i < 0 ? no_index : size_t(i); } },
+        { "binary_search10", binary_search10 },
+        { "binary_search11", binary_search11 },
+        { "binary_search",   binary_search },
+        { "sorted",          [](const vector_t& a, int t) { return sorted::binary_search(a, t); } },
+        { "branchless",      [](const vector_t& a, int t) { return binary_search_branchless(a, t); } },
+        { "std_lower_bound", [](const vector_t& a, int t) {
+                                 const auto it = std::lower_bound(a.cbegin(), a.cend(), t);
+                                 return it != a.cend() && *it == t ? size_t(it - a.cbegin()) : no_index; } },
+    };
+
+    /** Sizes from L1 resident (4 KiB) up to DRAM resident (256 MiB) of 4 byte elements */
+    std::vector<size_t> sizes() {
+        if( catch_perf_analysis ) {
+            return { 1UL << 10, 1UL << 13, 1UL << 16, 1UL << 19, 1UL << 22, 1UL << 25, 1UL << 26 };
+        } else {
+            return { 1UL << 10, 1UL << 16 };
+        }
+    }
+
+    /** Sorted array of `n` uniformly distributed random numbers */
+    vector_t make_uniform(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max());
+        vector_t v(n);
+        for(int& e : v) { e = dist(rng); }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    /** Sorted array of `n` uniformly distributed random numbers over the full `int` range, including negatives */
+    vector_t make_full_range(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+        vector_t v(n);
+        for(int& e : v) { e = dist(rng); }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    /** Sorted array of `n` random numbers within 16 dense clusters spread over the value range */
+    vector_t make_clustered(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> cluster(0, 15);
+        std::uniform_int_distribution<int> dist(0, int(std::min<size_t>(n, 1UL << 26)));
+        vector_t v(n);
+        for(int& e : v) { e = cluster(rng) * ( 1 << 27 ) + dist(rng); }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    /** Sorted array of `n` cubically growing numbers, dense at the start and sparse at the end */
+    vector_t make_skewed(size_t n) {
+        vector_t v(n);
+        const double dn = double(n);
+        for(size_t i=0; i<n; ++i) {
+            const double di = double(i);
+            v[i] = int(i) + int( di * di / dn * di / dn );
+        }
+        return v;
+    }
+
+    /** Sorted array of `n` timestamps, i.e. a start time plus random gaps of 1 to 16 units */
+    vector_t make_timestamps(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> gap(1, 16);
+        vector_t v(n);
+        int t = 1'000'000;
+        for(int& e : v) { t += gap(rng); e = t; }
+        return v;
+    }
+
+    /** Sorted array of `n` numbers with long runs of duplicates */
+    vector_t make_duplicates(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, 15);
+        vector_t v(n);
+        for(int& e : v) { e = dist(rng) * 3; }
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    typedef vector_t (*make_func)(size_t n);
+
+    const std::pair<const char*, make_func> distributions[] = {
+        { "uniform",   make_uniform },
+        { "clustered", make_clustered },
+        { "skewed",    make_skewed },
+    };
+
+    /** Random walk of `q` positions with steps of up to +/- `max_step`, i.e. lookups near the previous one */
+    std::vector<size_t> make_walk(size_t n, size_t q, int max_step) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(-max_step, max_step);
+        std::vector<size_t> v(q);
+        size_t p = n / 2;
+        for(size_t i=0; i<q; ++i) {
+            p = size_t( std::clamp<int64_t>(int64_t(p) + dist(rng), 0, int64_t(n) - 1) );
+            v[i] = p;
+        }
+        return v;
+    }
+
+    /** Sizes of 1M, 16M and 256M elements for the static B-tree comparison */
+    std::vector<size_t> stree_sizes() {
+        if( catch_perf_analysis ) {
+            return { 1UL << 20, 1UL << 24, 1UL << 28 };
+        } else {
+            return { 1UL << 12 };
+        }
+    }
+}
+
+TEST_CASE( "Binary Search Test 01", "[search]" ) {
+    using namespace bench_env;
+    for(size_t n : { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 100, 272, 273, 1000, 5000 }) {
+        const vector_t array = make_sorted_even(n);
+        for(const auto& [name, search] : variants) {
+            for(size_t i=0; i<n; ++i) {
+                REQUIRE_MSG(std::string(name)+" hit "+std::to_string(n), i == search(array, array[i]));
+                REQUIRE_MSG(std::string(name)+" miss "+std::to_string(n), no_index == search(array, array[i]+1));
+            }
+            REQUIRE_MSG(std::string(name)+" miss "+std::to_string(n), no_index == search(array, -1));
+        }
+        {
+            vector_t targets;
+            for(size_t i=0; i<n; ++i) {
+                targets.push_back(array[i]);
+                targets.push_back(array[i]+1);
+            }
+            targets.push_back(-1);
+            std::vector<size_t> results;
+            binary_search_batch(array, targets, results);
+            REQUIRE( targets.size() == results.size() );
+            for(size_t i=0; i<n; ++i) {
+                REQUIRE_MSG("batch hit "+std::to_string(n), i == results[2*i]);
+                REQUIRE_MSG("batch miss "+std::to_string(n), no_index == results[2*i+1]);
+            }
+            REQUIRE_MSG("batch miss "+std::to_string(n), no_index == results.back());
+        }
+        const EytzingerIndex<int> eytzinger(array);
+        REQUIRE( n == eytzinger.size() );
+        for(size_t i=0; i<n; ++i) {
+            REQUIRE_MSG("eytzinger hit "+std::to_string(n), i == eytzinger.binary_search(array[i]));
+            REQUIRE_MSG("eytzinger miss "+std::to_string(n), no_index == eytzinger.binary_search(array[i]+1));
+        }
+        REQUIRE_MSG("eytzinger miss "+std::to_string(n), no_index == eytzinger.binary_search(-1));
+        const STreeIndex stree(array);
+        REQUIRE( n == stree.size() );
+        for(size_t i=0; i<n; ++i) {
+            REQUIRE_MSG("stree hit "+std::to_string(n), i == stree.binary_search(array[i]));
+            REQUIRE_MSG("stree miss "+std::to_string(n), no_index == stree.binary_search(array[i]+1));
+        }
+        REQUIRE_MSG("stree miss "+std::to_string(n), no_index == stree.binary_search(-1));
+    }
+}
+
+TEST_CASE( "Branchless Lower Bound Test 01", "[search]" ) {
+    const std::vector<int> array = { 1, 3, 3, 3, 5, 8, 8, 13 };
+    const std::span<const int> s(array);
+    for(int t = -1; t <= 15; ++t) {
+        const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+        REQUIRE_MSG("target "+std::to_string(t), exp == lower_bound_branchless(s, t));
+    }
+    REQUIRE( 0 == lower_bound_branchless(std::span<const int>(), 1) );
+    REQUIRE( 1 == binary_search_branchless(array, 3) );
+    REQUIRE( 5 == binary_search_branchless(array, 8) );
+    REQUIRE( no_index == binary_search_branchless(array, 4) );
+
+    std::vector<int> targets;
+    for(int t = -1; t <= 15; ++t) { targets.push_back(t); }
+    std::vector<size_t> results(targets.size());
+    lower_bound_batch<int>(s, targets, results);
+    for(size_t i=0; i<targets.size(); ++i) {
+        REQUIRE_MSG("batch target "+std::to_string(targets[i]), lower_bound_branchless(s, targets[i]) == results[i]);
+    }
+    lower_bound_batch<int>(std::span<const int>(), targets, results);
+    REQUIRE( std::all_of(results.cbegin(), results.cend(), [](size_t i) { return 0 == i; }) );
+}
+
+TEST_CASE( "Eytzinger Index Test 01", "[search]" ) {
+    const std::vector<int> array = { 1, 3, 3, 3, 5, 8, 8, 13 };
+    const EytzingerIndex<int> eytzinger(array);
+    for(int t = -1; t <= 15; ++t) {
+        const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+        REQUIRE_MSG("target "+std::to_string(t), exp == eytzinger.lower_bound(t));
+    }
+    REQUIRE( 1 == eytzinger.binary_search(3) );
+    REQUIRE( 5 == eytzinger.binary_search(8) );
+    REQUIRE( no_index == eytzinger.binary_search(4) );
+
+    const EytzingerIndex<int> empty(std::span<const int>{});
+    REQUIRE( 0 == empty.size() );
+    REQUIRE( 0 == empty.lower_bound(1) );
+    REQUIRE( no_index == empty.binary_search(1) );
+}
+
+TEST_CASE( "Static B-Tree Test 01", "[search]" ) {
+    const std::vector<int> array = { 1, 3, 3, 3, 5, 8, 8, 13, 21, 21, 34, 55, 89, 144, 233, 377, 377, 610 };
+    const STreeIndex stree(array);
+    REQUIRE( 2 == stree.height() );
+    for(int t = -1; t <= 700; ++t) {
+        const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+        REQUIRE_MSG("target "+std::to_string(t), exp == stree.lower_bound(t));
+    }
+    REQUIRE( 1 == stree.binary_search(3) );
+    REQUIRE( 15 == stree.binary_search(377) );
+    REQUIRE( no_index == stree.binary_search(4) );
+
+    const std::vector<int> max_array = { 1, std::numeric_limits<int>::max() };
+    const STreeIndex max_stree(max_array);
+    REQUIRE( 1 == max_stree.binary_search(std::numeric_limits<int>::max()) );
+
+    const STreeIndex empty(std::span<const int>{});
+    REQUIRE( 0 == empty.size() );
+    REQUIRE( 0 == empty.lower_bound(1) );
+    REQUIRE( no_index == empty.binary_search(1) );
+}
+
+TEST_CASE( "Interpolation and Exponential Search Test 01", "[search]" ) {
+    using namespace bench_env;
+    for(const auto& [dist_name, make] : distributions) {
+        for(size_t n : { 0, 1, 2, 5, 63, 64, 100, 1000, 5000 }) {
+            const vector_t array = make(n);
+            const std::span<const int> s(array);
+            const AdaptiveSearch<int> adaptive(s);
+            const std::string prefix = std::string(dist_name)+" "+std::to_string(n);
+            vector_t targets = { std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+            for(int v : array) {
+                targets.push_back(v-1);
+                targets.push_back(v);
+                targets.push_back(v+1);
+            }
+            for(size_t k=0; k<targets.size(); ++k) {
+                const int t = targets[k];
+                const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+                REQUIRE_MSG(prefix+" interpolation "+std::to_string(t), exp == lower_bound_interpolation(s, t));
+                REQUIRE_MSG(prefix+" adaptive "+std::to_string(t), exp == adaptive.lower_bound(t));
+                for(size_t hint : { size_t(0), n / 2, k / 3, n, no_index }) {
+                    REQUIRE_MSG(prefix+" exponential "+std::to_string(t)+" hint "+std::to_string(hint), exp == lower_bound_exponential(s, t, hint));
+                    REQUIRE_MSG(prefix+" adaptive "+std::to_string(t)+" hint "+std::to_string(hint), exp == adaptive.lower_bound(t, hint));
+                }
+                const size_t exp_idx = exp < n && array[exp] == t ? exp : no_index;
+                REQUIRE_MSG(prefix+" interpolation "+std::to_string(t), exp_idx == binary_search_interpolation(s, t));
+                REQUIRE_MSG(prefix+" exponential "+std::to_string(t), exp_idx == binary_search_exponential(s, t, k / 3));
+                REQUIRE_MSG(prefix+" adaptive "+std::to_string(t), exp_idx == adaptive.binary_search(t, k / 3));
+            }
+        }
+    }
+    {
+        typedef AdaptiveSearch<int>::mode mode;
+        const vector_t uniform = make_uniform(5000);
+        const AdaptiveSearch<int> au(uniform);
+        REQUIRE( au.uniform() );
+        REQUIRE( mode::binary == au.select(uniform[100]) );
+        REQUIRE( mode::exponential == au.select(uniform[101], 100) );
+        REQUIRE( mode::binary == au.select(uniform[4900], 100) );
+
+        const vector_t uniform_large = make_uniform(AdaptiveSearch<int>::interpolation_min_size);
+        const AdaptiveSearch<int> aul(uniform_large);
+        REQUIRE( aul.uniform() );
+        REQUIRE( mode::interpolation == aul.select(uniform_large[100]) );
+        REQUIRE( mode::exponential == aul.select(uniform_large[101], 100) );
+        REQUIRE( mode::interpolation == aul.select(uniform_large[1000000], 100) );
+
+        const vector_t clustered = make_clustered(5000);
+        const AdaptiveSearch<int> ac(clustered);
+        REQUIRE( !ac.uniform() );
+        REQUIRE( mode::binary == ac.select(clustered[100]) );
+        REQUIRE( mode::exponential == ac.select(clustered[4900], 100) );
+
+        const vector_t skewed = make_skewed(5000);
+        REQUIRE( !AdaptiveSearch<int>(skewed).uniform() );
+    }
+    {
+        // uint64_t keys near 2^63 differing by less than 2^11 convert to equal doubles
+        const uint64_t base = uint64_t(1) << 63;
+        std::vector<uint64_t> array(600);
+        for(size_t i=0; i<array.size(); ++i) { array[i] = base + 3*i; }
+        const std::span<const uint64_t> s(array);
+        for(uint64_t t = base - 2; t < base + 3*array.size() + 2; ++t) {
+            const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+            REQUIRE_MSG("uint64_t interpolation "+std::to_string(t), exp == lower_bound_interpolation(s, t));
+        }
+    }
+}
+
+TEST_CASE( "Learned Index Test 01", "[search][learned]" ) {
+    using namespace bench_env;
+    const std::pair<const char*, make_func> learned_distributions[] = {
+        { "uniform",    make_uniform },
+        { "clustered",  make_clustered },
+        { "skewed",     make_skewed },
+        { "timestamps", make_timestamps },
+        { "duplicates", make_duplicates },
+        { "full range", make_full_range },
+    };
+    for(const auto& [dist_name, make] : learned_distributions) {
+        for(size_t n : { 0, 1, 2, 5, 100, 1000, 20000 }) {
+            const vector_t array = make(n);
+            const PGMIndex<int, 8, 2> pgm8(array);
+            const PGMIndex<int> pgm64(array);
+            REQUIRE( n == pgm64.size() );
+            const std::string prefix = std::string(dist_name)+" "+std::to_string(n);
+            vector_t targets = { std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+            for(int v : array) {
+                if( v > std::numeric_limits<int>::min() ) { targets.push_back(v-1); }
+                targets.push_back(v);
+                if( v < std::numeric_limits<int>::max() ) { targets.push_back(v+1); }
+            }
+            for(int t : targets) {
+                const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+                REQUIRE_MSG(prefix+" pgm8 "+std::to_string(t), exp == pgm8.lower_bound(t));
+                REQUIRE_MSG(prefix+" pgm64 "+std::to_string(t), exp == pgm64.lower_bound(t));
+                const size_t exp_idx = exp < n && array[exp] == t ? exp : no_index;
+                REQUIRE_MSG(prefix+" pgm64 "+std::to_string(t), exp_idx == pgm64.binary_search(t));
+            }
+        }
+    }
+    {
+        // a linear distribution is covered by a single segment
+        const vector_t array = make_sorted_even(100000);
+        const PGMIndex<int> pgm(array);
+        REQUIRE( 1 == pgm.height() );
+        REQUIRE( 1 == pgm.segment_count() );
+    }
+    {
+        // negative and full range keys, whose differences exceed the `int` range
+        const vector_t array = make_full_range(100000);
+        const PGMIndex<int> pgm(array);
+        REQUIRE( pgm.height() < 8 );
+        for(size_t i=0; i<array.size(); i+=97) {
+            REQUIRE( size_t( std::lower_bound(array.cbegin(), array.cend(), array[i]) - array.cbegin() ) == pgm.lower_bound(array[i]) );
+        }
+        const vector_t extremes = { std::numeric_limits<int>::min(), -1, 0, 1, std::numeric_limits<int>::max() };
+        const PGMIndex<int, 8, 2> pgm_extremes(extremes);
+        for(size_t i=0; i<extremes.size(); ++i) {
+            REQUIRE( i == pgm_extremes.binary_search(extremes[i]) );
+        }
+    }
+    {
+        // closely spaced double keys followed by a wide gap, extrapolating a steep slope across the gap
+        std::vector<double> array;
+        for(size_t i=0; i<100; ++i) { array.push_back(1.0 + double(i) * 1e-15); }
+        for(size_t i=0; i<100; ++i) { array.push_back(1e300 + double(i) * 1e285); }
+        const PGMIndex<double, 8, 2> pgm(array);
+        for(double t : { 0.0, 1.0, 1.5, 1e100, 1e200, 1e299, 1e300, 2e300, std::numeric_limits<double>::infinity() }) {
+            const size_t exp = size_t( std::lower_bound(array.cbegin(), array.cend(), t) - array.cbegin() );
+            REQUIRE_MSG("double "+std::to_string(t), exp == pgm.lower_bound(t));
+        }
+        for(size_t i=0; i<array.size(); ++i) {
+            REQUIRE( i == pgm.binary_search(array[i]) );
+        }
+    }
+}
+
+namespace test_env {
+    struct Record {
+        uint64_t key;
+        std::array<char, 8> tag;
+    };
+}
+
+TEST_CASE( "Generic Search Test 01", "[search][generic]" ) {
+    using namespace test_env;
+    static_assert( sorted::arithmetic_projection<uint64_t, std::identity> );
+    static_assert( sorted::arithmetic_projection<Record, decltype(&Record::key)> );
+    static_assert( !sorted::arithmetic_projection<std::array<char, 8>, std::identity> );
+    {
+        // uint64_t keys w/ duplicates
+        const std::vector<uint64_t> array = { 1, 3, 3, 3, 5, 8, 8, 13, uint64_t(1) << 40 };
+        for(uint64_t t : { 0UL, 1UL, 2UL, 3UL, 4UL, 8UL, 13UL, 14UL, 1UL << 40, ( 1UL << 40 ) + 1 }) {
+            const auto [l, u] = std::equal_range(array.cbegin(), array.cend(), t);
+            const std::string msg = "target "+std::to_string(t);
+            REQUIRE_MSG(msg, size_t(l - array.cbegin()) == sorted::lower_bound(array, t));
+            REQUIRE_MSG(msg, size_t(u - array.cbegin()) == sorted::upper_bound(array, t));
+            REQUIRE_MSG(msg, std::make_pair(size_t(l - array.cbegin()), size_t(u - array.cbegin())) == sorted::equal_range(array, t));
+            REQUIRE_MSG(msg, ( l != u ? size_t(l - array.cbegin()) : no_index ) == sorted::binary_search(std::span<const uint64_t>(array), t));
+        }
+    }
+    {
+        // float keys, descending order
+        const std::vector<float> array = { 3.5f, 2.25f, 2.25f, 1.0f, -0.5f };
+        REQUIRE( 1 == sorted::lower_bound(array, 2.25f, std::ranges::greater()) );
+        REQUIRE( 3 == sorted::upper_bound(array, 2.25f, std::ranges::greater()) );
+        REQUIRE( 4 == sorted::binary_search(array, -0.5f, std::ranges::greater()) );
+        REQUIRE( no_index == sorted::binary_search(array, 0.0f, std::ranges::greater()) );
+        REQUIRE( 5 == sorted::lower_bound(array, -1.0f, std::ranges::greater()) );
+    }
+    {
+        // fixed-size byte strings and projection
+        const std::vector<Record> array = { { 7, {'a','b'} }, { 3, {'a','c'} }, { 9, {'a','c'} }, { 1, {'b'} }, { 2, {'z','z','z'} } };
+        const std::array<char, 8> ac = {'a','c'};
+        REQUIRE( std::make_pair(size_t(1), size_t(3)) == sorted::equal_range(array, ac, {}, &Record::tag) );
+        REQUIRE( 3 == sorted::binary_search(array, std::array<char, 8>{'b'}, {}, &Record::tag) );
+        REQUIRE( no_index == sorted::binary_search(array, std::array<char, 8>{'b','a'}, {}, &Record::tag) );
+        REQUIRE( 5 == sorted::lower_bound(array, std::array<char, 8>{'z','z','z','z'}, {}, &Record::tag) );
+
+        std::vector<std::array<char, 8>> tags;
+        for(const Record& r : array) { tags.push_back(r.tag); }
+        REQUIRE( 0 == sorted::lower_bound(tags, std::array<char, 8>{'a'}) );
+        REQUIRE( 1 == sorted::binary_search(tags, ac) );
+    }
+    {
+        // empty
+        const std::vector<int> array;
+        REQUIRE( 0 == sorted::lower_bound(array, 1) );
+        REQUIRE( 0 == sorted::upper_bound(array, 1) );
+        REQUIRE( no_index == sorted::binary_search(array, 1) );
+    }
+}
+
+TEST_CASE( "Binary Search Benchmark 01", "[search][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        const vector_t array = make_sorted_even(n);
+        const vector_t queries = make_queries(array, query_count);
+        for(const auto& [name, search] : variants) {
+            BENCHMARK(std::string(name)+" size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+                size_t found = 0;
+                for(int q : queries) {
+                    found += no_index != search(array, q);
+                }
+                return found;
+            };
+        }
+        {
+            std::vector<size_t> results(query_count);
+            BENCHMARK("batch size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+                binary_search_batch(array, queries, results);
+                return results.back();
+            };
+        }
+        const EytzingerIndex<int> eytzinger(array);
+        BENCHMARK("eytzinger size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+            size_t found = 0;
+            for(int q : queries) {
+                found += no_index != eytzinger.binary_search(q);
+            }
+            return found;
+        };
+    }
+}
+
+TEST_CASE( "Static B-Tree Benchmark 01", "[search][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : stree_sizes()) {
+        const vector_t array = make_sorted_even(n);
+        const vector_t queries = make_queries(array, query_count);
+        for(const auto& [name, search] : variants) {
+            BENCHMARK(std::string(name)+" size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+                size_t found = 0;
+                for(int q : queries) {
+                    found += no_index != search(array, q);
+                }
+                return found;
+            };
+        }
+        {
+            std::vector<size_t> results(query_count);
+            BENCHMARK("batch size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+                binary_search_batch(array, queries, results);
+                return results.back();
+            };
+        }
+        const STreeIndex stree(array);
+        BENCHMARK("stree size "+std::to_string(n)+" queries "+std::to_string(query_count)) {
+            size_t found = 0;
+            for(int q : queries) {
+                found += no_index != stree.binary_search(q);
+            }
+            return found;
+        };
+    }
+}
+
+TEST_CASE( "Interpolation and Exponential Search Benchmark 01", "[search][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        for(const auto& [dist_name, make] : distributions) {
+            const vector_t array = make(n);
+            const std::span<const int> s(array);
+            const AdaptiveSearch<int> adaptive(s);
+            const std::string suffix = std::string(dist_name)+" size "+std::to_string(n)+" queries "+std::to_string(query_count);
+
+            // random lookups, half hits and half (likely) misses
+            vector_t queries(query_count);
+            {
+                std::mt19937 rng(seed);
+                std::uniform_int_distribution<size_t> dist(0, n-1);
+                for(size_t i=0; i<query_count; ++i) { queries[i] = array[dist(rng)] + int(i & 1); }
+            }
+            BENCHMARK("binary random "+suffix) {
+                size_t found = 0;
+                for(int q : queries) { found += no_index != binary_search_branchless(s, q); }
+                return found;
+            };
+            BENCHMARK("interpolation random "+suffix) {
+                size_t found = 0;
+                for(int q : queries) { found += no_index != binary_search_interpolation(s, q); }
+                return found;
+            };
+            BENCHMARK("adaptive random "+suffix) {
+                size_t found = 0;
+                for(int q : queries) { found += no_index != adaptive.binary_search(q); }
+                return found;
+            };
+
+            // lookups near the previous one, using its result as hint
+            const std::vector<size_t> walk = make_walk(n, query_count, 64);
+            vector_t local(query_count);
+            for(size_t i=0; i<query_count; ++i) { local[i] = array[walk[i]]; }
+            BENCHMARK("binary local "+suffix) {
+                size_t found = 0;
+                for(int q : local) { found += no_index != binary_search_branchless(s, q); }
+                return found;
+            };
+            BENCHMARK("exponential local "+suffix) {
+                size_t found = 0, hint = n / 2;
+                for(int q : local) { hint = lower_bound_exponential(s, q, hint); found += hint < n; }
+                return found;
+            };
+            BENCHMARK("adaptive local "+suffix) {
+                size_t found = 0, hint = n / 2;
+                for(int q : local) { hint = adaptive.lower_bound(q, hint); found += hint < n; }
+                return found;
+            };
+        }
+    }
+}
+
+TEST_CASE( "Search Trace Benchmark 01", "[search][trace][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        const vector_t array = make_sorted_even(n);
+        const vector_t queries = make_queries(array, query_count);
+        const std::string suffix = " size "+std::to_string(n)+" queries "+std::to_string(query_count);
+
+        // binary_search() is binary_search11() w/o trace
+        BENCHMARK("binary_search untraced"+suffix) {
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search(array, q); }
+            return found;
+        };
+        BENCHMARK("binary_search11 no_trace"+suffix) {
+            no_trace trace;
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search11(array, q, trace); }
+            return found;
+        };
+        BENCHMARK("binary_search11 ring_trace"+suffix) {
+            ring_trace<64> trace;
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search11(array, q, trace); }
+            return found + trace.count();
+        };
+        BENCHMARK("binary_search10 no_trace"+suffix) {
+            no_trace trace;
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search10(array, q, trace); }
+            return found;
+        };
+        BENCHMARK("binary_search10 ring_trace"+suffix) {
+            ring_trace<64> trace;
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search10(array, q, trace); }
+            return found + trace.count();
+        };
+    }
+}
+
+TEST_CASE( "Learned Index Benchmark 01", "[search][learned][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        const vector_t array = make_timestamps(n);
+        const std::string suffix = " timestamps size "+std::to_string(n)+" queries "+std::to_string(query_count);
+        // random lookups, half hits and half (likely) misses
+        vector_t queries(query_count);
+        {
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<size_t> dist(0, n-1);
+            for(size_t i=0; i<query_count; ++i) { queries[i] = array[dist(rng)] + int(i & 1); }
+        }
+        BENCHMARK("binary_search"+suffix) {
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search(array, q); }
+            return found;
+        };
+        BENCHMARK("branchless"+suffix) {
+            size_t found = 0;
+            for(int q : queries) { found += no_index != binary_search_branchless(array, q); }
+            return found;
+        };
+        auto bench_pgm = [&]<size_t epsilon>(const PGMIndex<int, epsilon>& pgm) {
+            char buf[256];
+            std::snprintf(buf, sizeof(buf), "pgm%zu timestamps size %zu: height %zu, segments %zu, memory %zu bytes, %.4f bytes/key, %.4f%% of data",
+                          epsilon, n, pgm.height(), pgm.segment_count(), pgm.memory_usage(),
+                          double(pgm.memory_usage()) / double(n), 100.0 * double(pgm.memory_usage()) / double(n * sizeof(int)));
+            WARN(buf);
+            BENCHMARK("pgm"+std::to_string(epsilon)+suffix) {
+                size_t found = 0;
+                for(int q : queries) { found += no_index != pgm.binary_search(q); }
+                return found;
+            };
+        };
+        bench_pgm(PGMIndex<int, 16>(array));
+        bench_pgm(PGMIndex<int, 64>(array));
+        bench_pgm(PGMIndex<int, 256>(array));
+    }
+}
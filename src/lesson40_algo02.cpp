@@ -12,83 +12,20 @@
 
 #include <limits>
 #include <cassert>
+#include <cstdint>
+
+#include "cpp_basics/search.hpp"
+#include "cpp_basics/sorted_array.hpp"
 
 /**
  * Lesson 4.0
  *
  * Implementing binary search on a sorted array and sorted insert
+ *
+ * binary_search() and no_index are shared via cpp_basics/search.hpp,
+ * ordered_insert() via cpp_basics/sorted_array.hpp
  */
 
-constexpr static const size_t no_index = std::numeric_limits<size_t>::max();
-
-//
-// full array value space using size_t, excluding lower and upper bounds initially
-//
-size_t binary_search(const std::vector<int>& array, int target_value) {
-    size_t l = 0;
-    size_t h = array.size()-1;
-    if ( array[l] == target_value ) {
-        return l;
-    } else if ( array[h] == target_value ) {
-        return h;
-    }
-    size_t c = 0;
-    while( h - l >= 2 ) {
-        // size_t i = ( l + h ) / 2; // l+h too big?
-        size_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
-        // std::cout << "c " << c << " [" << l << ".." << h << "]: p " << i << std::endl;
-        if ( array[i] < target_value ) {
-            l = i;
-        } else if ( array[i] > target_value ) {
-            h = i;
-        } else {
-            return i;
-        }
-        ++c;
-    }
-    (void)c;
-    return no_index;
-}
-size_t ordered_insert(std::vector<int>& array, int value) {
-    if( array.size() < 1 ) {
-        array.push_back(value);
-        return 0;
-    }
-    // Because std::vector<>::begin() iterator performs arithmetic
-    // using a signed difference_type, we need to use such a signed type
-    // here to avoid `bugprone-narrowing-conversions` (LINT)
-    //
-    // Now, isn't this odd as std::vector<>::size() uses unsigned size_type,
-    // aka size_t and mentioned iterator hence lose half the value range possible?
-    typedef std::vector<int>::difference_type iterdiff_t;
-    iterdiff_t l = 0;
-    iterdiff_t h = array.cend() - array.cbegin() - 1;
-    if ( array[l] >= value ) {
-        array.insert(array.begin(), value);
-        return l;
-    } else if ( array[h] <= value ) {
-        array.insert(array.end(), value);
-        return h+1;
-    }
-    // size_t c = 0;
-    while( h - l >= 2 ) {
-        // iterdiff_t i = ( l + h ) / 2; // l+h too big?
-        iterdiff_t i = l + ( h - l ) / 2; // better, also solved with std::midpoint(l, h)
-        // std::cout << "c " << c << " (" << l << ".." << h << "): p " << i << std::endl;
-        if ( array[i] < value ) {
-            l = i;
-        } else if ( array[i] > value ) {
-            h = i;
-        } else {
-            array.insert(array.begin() + i, value);
-            return i;
-        }
-        // ++c;
-    }
-    array.insert(array.begin() + h, value);
-    return h;
-}
-
 bool test_binsearch(const std::vector<int>& array, int target_value, size_t exp_idx, size_t& has_idx) {
     has_idx = binary_search(array, target_value);
     if( exp_idx != has_idx ) {
@@ -146,6 +83,18 @@ void test_ordered_insert(std::vector<int>& array_in, const std::vector<int>& arr
     assert( array == array_exp );
 }
 
+void test_ordered_insert_bulk(const std::vector<int>& array_in, const std::vector<int>& values) {
+    std::vector<int> array_exp = array_in;
+    for(int v : values) {
+        ordered_insert(array_exp, v);
+    }
+    std::vector<int> array = array_in;
+    ordered_insert(array, values);
+    printVec("BULK", array);
+    assert( array.size() == array_in.size() + values.size() );
+    assert( array == array_exp );
+}
+
 int main(int, const char**) {
 
     // test binary search
@@ -173,5 +122,29 @@ int main(int, const char**) {
         }
 
     }
+    // test bulk ordered insert
+    {
+        test_ordered_insert_bulk({ }, { });
+        test_ordered_insert_bulk({ }, { 2, 8, 1, 6, 0 });
+        test_ordered_insert_bulk({ 1, 3, 5 }, { });
+        test_ordered_insert_bulk({ 0, 1, 2, 3, 4 }, { 9, 8, 7, 6, 5 });
+        test_ordered_insert_bulk({ 5, 6, 7, 8, 9 }, { 4, 3, 2, 1, 0 });
+        test_ordered_insert_bulk({ 1, 3, 3, 5, 9 }, { 3, 0, 9, 4, 3, 10, 1 });
+        test_ordered_insert_bulk({ 2, 2, 2 }, { 2, 2 });
+    }
+    // test generic typed search and ordered insert, see cpp_basics/search.hpp
+    {
+        std::vector<uint64_t> array;
+        for(uint64_t v : { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }) {
+            const size_t p = sorted::ordered_insert(array, v << 40);
+            assert( array[p] == v << 40 );
+        }
+        for(size_t i=0; i<array.size(); ++i) {
+            assert( i == sorted::binary_search(array, uint64_t(i) << 40) );
+            assert( no_index == sorted::binary_search(array, ( uint64_t(i) << 40 ) + 1) );
+        }
+        sorted::ordered_insert(array, std::vector<uint64_t>{ 5UL << 40, 5UL << 40 });
+        assert( std::make_pair(size_t(5), size_t(8)) == sorted::equal_range(array, uint64_t(5) << 40) );
+    }
     return 0;
 }
@@ -0,0 +1,213 @@
+//============================================================================
+// Author      : Svenson Han Göthel and Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Benchmarking sorted insert and sorted containers
+//============================================================================
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <random>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/sorted_array.hpp"
+
+/**
+ * Lesson 4.0 Benchmark of sorted insert into a plain vector via ordered_insert(),
+ * per value and in bulk of batch_size values, the PackedMemoryArray and std::multiset.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> <operation> <n>` and processes `n` elements,
+ * see cpp_basics::BenchCSVListener.
+ */
+namespace bench_env {
+    typedef std::vector<int> vector_t;
+
+    constexpr static const uint32_t seed = 0x1234567;
+
+    /** ordered_insert() is quadratic, hence limited to this size */
+    constexpr static const size_t ordered_insert_max_n = 100'000;
+
+    /** Number of values per ordered_insert() bulk call */
+    constexpr static const size_t batch_size = 1000;
+
+    /** ordered_insert() in bulk is still O(n^2 / batch_size), hence limited to this size */
+    constexpr static const size_t ordered_insert_bulk_max_n = 1'000'000;
+
+    /** Random keys in range [0..n) */
+    vector_t make_uniform(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, int(n)-1);
+        vector_t v(n);
+        for(int& e : v) { e = dist(rng); }
+        return v;
+    }
+
+    std::vector<size_t> sizes() {
+        if( catch_perf_analysis ) {
+            return { 10'000, 100'000, 1'000'000, 10'000'000 };
+        } else {
+            return { 1'000, 10'000 };
+        }
+    }
+}
+
+TEST_CASE( "Packed Memory Array Test 01", "[sorted][pma]" ) {
+    using namespace bench_env;
+    {
+        PackedMemoryArray<int> pma;
+        REQUIRE( pma.empty() );
+        REQUIRE( pma.begin() == pma.end() );
+        REQUIRE( pma.end() == pma.lower_bound(1) );
+        REQUIRE( !pma.contains(1) );
+    }
+    for(size_t n : { 1, 7, 8, 9, 100, 1000, 20000 }) {
+        const vector_t keys = make_uniform(n);
+        PackedMemoryArray<int> pma;
+        std::multiset<int> ref;
+        vector_t array;
+        for(int k : keys) {
+            pma.insert(k);
+            ref.insert(k);
+            ordered_insert(array, k);
+        }
+        REQUIRE( n == pma.size() );
+        REQUIRE( n <= pma.capacity() );
+        REQUIRE( std::equal(pma.begin(), pma.end(), ref.cbegin(), ref.cend()) );
+        REQUIRE( std::equal(pma.begin(), pma.end(), array.cbegin(), array.cend()) );
+        vector_t bulk;
+        for(size_t b=0; b<n; b+=batch_size) {
+            ordered_insert(bulk, vector_t(keys.cbegin() + b, keys.cbegin() + std::min(n, b + batch_size)));
+        }
+        REQUIRE( array == bulk );
+        for(int t = -1; t <= int(n); ++t) {
+            const auto it = pma.lower_bound(t);
+            const auto exp = ref.lower_bound(t);
+            REQUIRE_MSG("lower_bound "+std::to_string(t), ( exp == ref.cend() ) == ( it == pma.end() ));
+            if( exp != ref.cend() ) {
+                REQUIRE_MSG("lower_bound "+std::to_string(t), *exp == *it);
+                REQUIRE_MSG("distance "+std::to_string(t), std::distance(ref.cbegin(), exp) == std::distance(pma.begin(), it));
+            }
+            REQUIRE_MSG("contains "+std::to_string(t), ref.contains(t) == pma.contains(t));
+        }
+    }
+    {
+        // ascending and descending ingest, worst case for a single segment
+        PackedMemoryArray<int> up, down;
+        for(int i=0; i<10000; ++i) {
+            up.insert(i);
+            down.insert(10000-1-i);
+        }
+        REQUIRE( std::is_sorted(up.begin(), up.end()) );
+        REQUIRE( std::equal(up.begin(), up.end(), down.begin(), down.end()) );
+        REQUIRE( 10000 == std::distance(up.begin(), up.end()) );
+    }
+}
+
+TEST_CASE( "Generic Sorted Insert Test 01", "[sorted][generic]" ) {
+    using namespace bench_env;
+    struct Record {
+        uint64_t key;
+        size_t seq;
+    };
+    const vector_t keys = make_uniform(1000);
+    std::vector<Record> in;
+    for(size_t i=0; i<keys.size(); ++i) { in.push_back( { uint64_t(keys[i] % 100), i } ); }
+    std::vector<Record> exp = in;
+    std::ranges::stable_sort(exp, std::ranges::less(), &Record::key);
+
+    std::vector<Record> single;
+    for(const Record& r : in) {
+        const size_t p = sorted::ordered_insert(single, r, {}, &Record::key);
+        REQUIRE( single[p].seq == r.seq );
+    }
+    std::vector<Record> bulk;
+    for(size_t b=0; b<in.size(); b+=batch_size/8) {
+        sorted::ordered_insert(bulk, std::vector<Record>(in.cbegin() + ptrdiff_t(b), in.cbegin() + ptrdiff_t(std::min(in.size(), b + batch_size/8))), {}, &Record::key);
+    }
+    auto same = [](const Record& a, const Record& b) { return a.key == b.key && a.seq == b.seq; };
+    REQUIRE( std::ranges::equal(exp, single, same) );
+    REQUIRE( std::ranges::equal(exp, bulk, same) );
+
+    std::vector<float> fl;
+    for(float f : { 2.5f, -1.0f, 2.5f, 0.0f }) { sorted::ordered_insert(fl, f); }
+    REQUIRE( std::vector<float>{ -1.0f, 0.0f, 2.5f, 2.5f } == fl );
+}
+
+TEST_CASE( "Sorted Insert Benchmark 01", "[sorted][pma][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        const vector_t keys = make_uniform(n);
+        const std::string sn = std::to_string(n);
+        if( n <= ordered_insert_max_n ) {
+            BENCHMARK("ordered_insert ingest "+sn) {
+                vector_t array;
+                for(int k : keys) { ordered_insert(array, k); }
+                return array.size();
+            };
+        }
+        if( n <= ordered_insert_bulk_max_n ) {
+            BENCHMARK("ordered_insert_bulk ingest "+sn) {
+                vector_t array;
+                for(size_t b=0; b<n; b+=batch_size) {
+                    ordered_insert(array, vector_t(keys.cbegin() + b, keys.cbegin() + std::min(n, b + batch_size)));
+                }
+                return array.size();
+            };
+        }
+        BENCHMARK("pma ingest "+sn) {
+            PackedMemoryArray<int> pma;
+            for(int k : keys) { pma.insert(k); }
+            return pma.size();
+        };
+        BENCHMARK("multiset ingest "+sn) {
+            std::multiset<int> set;
+            for(int k : keys) { set.insert(k); }
+            return set.size();
+        };
+
+        vector_t array(keys);
+        std::sort(array.begin(), array.end());
+        PackedMemoryArray<int> pma;
+        std::multiset<int> set;
+        for(int k : keys) { pma.insert(k); set.insert(k); }
+
+        BENCHMARK("vector scan "+sn) {
+            int64_t sum = 0;
+            for(int k : array) { sum += k; }
+            return sum;
+        };
+        BENCHMARK("pma scan "+sn) {
+            int64_t sum = 0;
+            for(int k : pma) { sum += k; }
+            return sum;
+        };
+        BENCHMARK("multiset scan "+sn) {
+            int64_t sum = 0;
+            for(int k : set) { sum += k; }
+            return sum;
+        };
+
+        BENCHMARK("binary_search lookup "+sn) {
+            size_t found = 0;
+            for(int k : keys) { found += no_index != binary_search_branchless(array, k+1); }
+            return found;
+        };
+        BENCHMARK("pma lookup "+sn) {
+            size_t found = 0;
+            for(int k : keys) { found += pma.contains(k+1); }
+            return found;
+        };
+        BENCHMARK("multiset lookup "+sn) {
+            size_t found = 0;
+            for(int k : keys) { found += set.contains(k+1); }
+            return found;
+        };
+    }
+}
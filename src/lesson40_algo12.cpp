@@ -9,9 +9,13 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <functional>
+#include <span>
 
 #include <cassert>
 
+#include "cpp_basics/qsort.hpp"
+
 namespace test_env {
     /**
      * Test Value value type implementing constraints
@@ -63,301 +67,6 @@ namespace std {
     }
 }
 
-namespace impl_common {
-
-    template<typename V>
-    void printVec(const std::vector<V>& v, size_t b, size_t e, size_t p) {
-        const size_t range = e - b;
-        std::cout << "Vec sz " << v.size() << ": [" << b << ".." << e << ") " << range << ", p " << p << ": ";
-        for(size_t k=0; k<v.size(); ++k) {
-            std::cout << "[" << k << "] " << v[k] << ", ";
-        }
-        std::cout << std::endl;
-    }
-
-    template<typename V>
-    using VecIterator = typename std::vector<V>::iterator;
-
-}
-
-namespace hoare0 {
-
-    using namespace impl_common;
-
-    /**
-     * Hoare quicksort of range [b..e).
-     *
-     * Quicksort by Tony Hoare in 1959, published 1961.
-     *
-     * @tparam V
-     * @param array
-     * @param b left start index, inclusive
-     * @param e right end index, exclusive
-     * @return number of partitioning
-     */
-    template<typename V>
-    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
-        if( e - b < 2 ) {
-            return 0;
-        }
-        // Partitioning:
-        // Stick with using references for comparison, no copy
-        size_t l=b;   // left index
-        size_t r=e-1; // right index -> pivot point
-        const V& p = A[b]; // Pivot, ref only
-        while( true ) {
-            // b -> low pivot index
-            while(A[l] < p) { ++l; }
-
-            while(A[r] > p) { --r; }
-
-            if(l >= r) {
-                break;
-            }
-            std::swap(A[l], A[r]);
-        }
-        // printVec(array, b, e, pivot);
-
-        // Recursion:
-        size_t c = 1;
-        c += qsort(A, b,   r+1); // left side of pivot, pivot included
-        c += qsort(A, r+1, e);   // right side of pivot
-        return c;
-    }
-    template<typename V>
-    size_t qsort(std::vector<V>& array) {
-        return qsort(array, 0, array.size());
-    }
-}
-
-namespace hoare1 {
-
-    using namespace impl_common;
-
-    /**
-     * Hoare-Sedgewick quicksort of range [b..e).
-     *
-     * Quicksort by Tony Hoare in 1959, published 1961.
-     *
-     * @tparam V
-     * @param array
-     * @param b left start index, inclusive
-     * @param e right end index, exclusive
-     * @return number of partitioning
-     */
-    template<typename V>
-    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
-        if( e - b < 2 ) {
-            return 0;
-        }
-        // Partitioning:
-        // Stick with using references for comparison, no copy
-        size_t l=b;   // left index  -> pivot-point
-        size_t r=e-2; // right index
-        const size_t hi = e-1;
-        const V& p = A[hi]; // Pivot, ref only
-        while( true ) {
-            while(A[l] < p) { ++l; }
-
-            while(r > 0 && A[r] > p) { --r; }
-
-            // std::cout << ": [" << l << ".." << r << "]" << std::endl;
-
-            if( r > l ) {
-                std::swap(A[l], A[r]);
-            } else {
-                std::swap(A[l], A[hi]); // move pivot to final position
-                break; // done
-            }
-        }
-        // printVec(A, b, e, pivot);
-
-        // Recursion:
-        size_t c = 1;
-        c += qsort(A, b,   l); // left side of pivot
-        c += qsort(A, l+1, e); // right side of pivot
-        return c;
-    }
-    template<typename V>
-    size_t qsort(std::vector<V>& array) {
-        return qsort(array, 0, array.size());
-    }
-}
-
-namespace lumoto {
-
-    using namespace impl_common;
-
-    /**
-     * Hoare-Lomuto quicksort of range [b..e).
-     *
-     * Quicksort by Tony Hoare in 1959, published 1961.
-     *
-     * @tparam V
-     * @param array
-     * @param b left start index, inclusive
-     * @param e right end index, exclusive
-     * @return number of partitioning
-     */
-    template<typename V>
-    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
-        if( e - b < 2 ) {
-            return 0;
-        }
-        // Partitioning:
-        // Stick with using references for comparison, no copy
-        const size_t hi = e - 1;
-        const V& p = A[hi]; // Pivot, ref only
-        size_t l = b; // pivot point
-        for(size_t j = b; j < hi; ++j) {
-            if( A[j] <= p ) { // pivot value array[hi]
-                std::swap(A[l], A[j]);
-                ++l; // move temp pivot index forward
-            }
-        }
-        std::swap(A[l], A[hi]); // move pivot to final position
-        // printVec(array, b, e, pivot);
-
-        // Recursion:
-        size_t c = 1;
-        c += qsort(A, b,   l); // left side of pivot
-        c += qsort(A, l+1, e); // right side of pivot
-        return c;
-    }
-    template<typename V>
-    size_t qsort(std::vector<V>& array) {
-        return qsort(array, 0, array.size());
-    }
-}
-
-namespace hoare2 {
-
-    using namespace impl_common;
-
-    /**
-     * Hoare alike quicksort of range [b..e).
-     *
-     * Difference to Hoare's partitioning is using dedicated loops for each side of the pivot
-     * to move the element over to the other side.
-     * It uses a middle index pivot.
-     *
-     * The pivot element is sorted in place and not included in the recursion like
-     * Lumoto and Sedgewick but unlike Hoare.
-     *
-     * Quicksort by Tony Hoare in 1959, published 1961.
-     *
-     * @tparam V
-     * @param array
-     * @param b left start index, inclusive
-     * @param e right end index, exclusive
-     * @return number of partitioning
-     */
-    template<typename V>
-    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
-        if( e - b < 2 ) {
-            return 0;
-        }
-        A.reserve( A.size() + 1 );
-        // Partitioning:
-        // Stick with using references for comparison, no copy
-        // size_t l = ( b + e - 1 ) / 2; // pivot point - sum too big?
-        size_t l = b + ( e - 1 - b ) / 2; // pivot point - better, also solved with std::midpoint(b, e-1)
-        for(size_t i = b; i < l; ) {
-            if( A[i] > A[l] ) {
-                A.insert(A.begin() + e, A[i]);
-                A.erase( A.begin() + i );
-                --l;
-            } else {
-                ++i;
-            }
-        }
-        for(size_t i = l+1; i < e; ) {
-            if( A[i] < A[l] ) {
-                A.insert(A.begin() + b, A[i]);
-                ++i;
-                ++l;
-                A.erase( A.begin() + i );
-            } else {
-                ++i;
-            }
-        }
-        // printVec(array, b, e, pivot);
-
-        // Recursion:
-        size_t c = 1;
-        c += qsort(A, b,   l); // left side of pivot
-        c += qsort(A, l+1, e); // right side of pivot
-        return c;
-    }
-    template<typename V>
-    size_t qsort(std::vector<V>& array) {
-        return qsort(array, 0, array.size());
-    }
-}
-
-namespace hoare3 {
-
-    using namespace impl_common;
-
-    /**
-     * Hoare-Yaroslavskiy dual-pivot quicksort of range [b..e).
-     *
-     * Quicksort by Tony Hoare in 1959, published 1961.
-     *
-     * @tparam V
-     * @param array
-     * @param b left start index, inclusive
-     * @param e right end index, exclusive
-     * @return number of partitioning
-     */
-    template<typename V>
-    size_t qsort(std::vector<V>& A, size_t b, size_t e) {
-        if( e - b < 2 ) {
-            return 0;
-        }
-        // Partitioning:
-        // Stick with using references for comparison, no copy
-        const size_t hi = e-1;
-        size_t l = b + 1, g = hi - 1; // pivot points
-        {
-            if( A[b] > A[hi] ) {
-                std::swap(A[b], A[hi]);
-            }
-            const V& p = A[b];  // Pivot 1, ref only
-            const V& q = A[hi]; // Pivot 2, ref only
-            size_t k = l;
-            while (k <= g) {
-                if (A[k] < p) {
-                    std::swap(A[k], A[l]); ++l;
-                } else if( A[k] >= q ) {
-                    while( A[g] > q && k < g ) {
-                     --g;
-                    }
-                    std::swap(A[k], A[g]); --g;
-                    if( A[k] < p ) {
-                        std::swap(A[k], A[l]); ++l;
-                    }
-                }
-                ++k;
-            }
-            --l; ++g;
-            std::swap(A[b],  A[l]);
-            std::swap(A[hi], A[g]);
-        }
-
-        // Recursion
-        size_t c = 1;
-        c += qsort(A, b,   l); // 1st segment, ex-pivot
-        c += qsort(A, l+1, g); // 2nd segment, ex-pivot
-        c += qsort(A, g+1, e); // 3rd segment, ex-pivot
-        return c;
-    }
-    template<typename V>
-    size_t qsort(std::vector<V>& array) {
-        return qsort(array, 0, array.size());
-    }
-}
-
 //
 // test code
 //
@@ -390,6 +99,108 @@ void test_qsort(const std::string& prefix, const test_vector_t& has, const test_
     test_qsort("qsort-hoare_yaro-"+prefix, hoare3::qsort, has, exp);
 }
 
+void test_qsort_generic(const std::string& prefix, const test_vector_t& has, const test_vector_t& exp) {
+    // random access iterator pair
+    test_qsort("qsort-iter-hoare_goth-"+prefix, [](test_vector_t& a) { return hoare2::qsort(a.begin(), a.end()); }, has, exp);
+    test_qsort("qsort-iter-hoare_sedg-"+prefix, [](test_vector_t& a) { return hoare1::qsort(a.begin(), a.end()); }, has, exp);
+    test_qsort("qsort-iter-hoare_tony-"+prefix, [](test_vector_t& a) { return hoare0::qsort(a.begin(), a.end()); }, has, exp);
+    test_qsort("qsort-iter-lumoto____-"+prefix, [](test_vector_t& a) { return lumoto::qsort(a.begin(), a.end()); }, has, exp);
+    test_qsort("qsort-iter-hoare_yaro-"+prefix, [](test_vector_t& a) { return hoare3::qsort(a.begin(), a.end()); }, has, exp);
+    // std::span
+    test_qsort("qsort-span-hoare_goth-"+prefix, [](test_vector_t& a) { return hoare2::qsort(std::span(a)); }, has, exp);
+    test_qsort("qsort-span-hoare_sedg-"+prefix, [](test_vector_t& a) { return hoare1::qsort(std::span(a)); }, has, exp);
+    test_qsort("qsort-span-hoare_tony-"+prefix, [](test_vector_t& a) { return hoare0::qsort(std::span(a)); }, has, exp);
+    test_qsort("qsort-span-lumoto____-"+prefix, [](test_vector_t& a) { return lumoto::qsort(std::span(a)); }, has, exp);
+    test_qsort("qsort-span-hoare_yaro-"+prefix, [](test_vector_t& a) { return hoare3::qsort(std::span(a)); }, has, exp);
+}
+
+void test_qsort_iterative(const std::string& prefix, const test_vector_t& has, const test_vector_t& exp) {
+    test_qsort("qsort-loop-hoare_goth-"+prefix, hoare2::qsort_iterative, has, exp);
+    test_qsort("qsort-loop-hoare_sedg-"+prefix, hoare1::qsort_iterative, has, exp);
+    test_qsort("qsort-loop-hoare_tony-"+prefix, hoare0::qsort_iterative, has, exp);
+    test_qsort("qsort-loop-lumoto____-"+prefix, lumoto::qsort_iterative, has, exp);
+    test_qsort("qsort-loop-hoare_yaro-"+prefix, hoare3::qsort_iterative, has, exp);
+}
+
+namespace test_env {
+    struct Record {
+        int64_t key;
+        std::string name;
+
+        bool operator==(const Record&) const noexcept = default;
+    };
+}
+
+typedef std::vector<test_env::Record> test_record_vector_t;
+
+typedef size_t (*qsort_record_func)(test_record_vector_t& array);
+
+void test_qsort_record(const std::string& prefix, qsort_record_func qsort, test_record_vector_t has, const test_record_vector_t& exp) {
+    const size_t c = qsort(has);
+    std::cout << prefix << ": sz " << has.size() << ", qs-c " << c << ": ";
+    for(size_t k=0; k<has.size(); ++k) {
+        std::cout << "[" << k << "] " << has[k].key << " " << has[k].name << ", ";
+    }
+    std::cout << std::endl;
+    assert( exp == has );
+}
+/** Descending order via comparator std::greater and projection on Record::key */
+void test_qsort_record(const std::string& prefix, const test_record_vector_t& has, const test_record_vector_t& exp) {
+    using test_env::Record;
+    test_qsort_record("qsort-proj-hoare_goth-"+prefix, [](test_record_vector_t& a) { return hoare2::qsort(a.begin(), a.end(), std::greater<>(), &Record::key); }, has, exp);
+    test_qsort_record("qsort-proj-hoare_sedg-"+prefix, [](test_record_vector_t& a) { return hoare1::qsort(a.begin(), a.end(), std::greater<>(), &Record::key); }, has, exp);
+    test_qsort_record("qsort-proj-hoare_tony-"+prefix, [](test_record_vector_t& a) { return hoare0::qsort(a.begin(), a.end(), std::greater<>(), &Record::key); }, has, exp);
+    test_qsort_record("qsort-proj-lumoto____-"+prefix, [](test_record_vector_t& a) { return lumoto::qsort(a.begin(), a.end(), std::greater<>(), &Record::key); }, has, exp);
+    test_qsort_record("qsort-proj-hoare_yaro-"+prefix, [](test_record_vector_t& a) { return hoare3::qsort(a.begin(), a.end(), std::greater<>(), &Record::key); }, has, exp);
+}
+
+/** Sorting the sub-range [2..8) of a plain array via std::span, leaving the outer elements untouched */
+void test_qsort_subrange() {
+    const int in[]  = { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+    const int exp[] = { 9, 8, 2, 3, 4, 5, 6, 7, 1, 0 };
+    typedef size_t (*qsort_span_func)(std::span<int> s);
+    const qsort_span_func sorter[] = {
+        [](std::span<int> s) { return hoare0::qsort(s); }, [](std::span<int> s) { return hoare1::qsort(s); },
+        [](std::span<int> s) { return lumoto::qsort(s); }, [](std::span<int> s) { return hoare2::qsort(s); },
+        [](std::span<int> s) { return hoare3::qsort(s); } };
+    for(qsort_span_func qsort : sorter) {
+        int has[10];
+        std::copy(std::begin(in), std::end(in), std::begin(has));
+        qsort(std::span<int>(has).subspan(2, 6));
+        assert( std::equal(std::begin(exp), std::end(exp), std::begin(has)) );
+    }
+}
+
+void test_qsort_strings(const std::string& prefix, std::vector<std::string> has, const std::vector<std::string>& exp) {
+    const size_t c = multikey::qsort(has);
+    std::cout << "qsort-multikey-" << prefix << ": sz " << has.size() << ", qs-c " << c << ": ";
+    for(size_t k=0; k<has.size(); ++k) {
+        std::cout << "[" << k << "] " << has[k] << ", ";
+    }
+    std::cout << std::endl;
+    assert( exp == has );
+}
+
+typedef size_t (*qsort_stats_func)(test_vector_t& array, impl_common::sort_stats& st);
+
+void test_qsort_stats(const std::string& prefix, qsort_stats_func qsort, test_vector_t has, const test_vector_t& exp) {
+    impl_common::sort_stats st;
+    const size_t c = qsort(has, st);
+    std::cout << prefix << ": sz " << has.size() << ", qs-c " << c << ": " << st.toString() << std::endl;
+    assert( exp == has );
+    assert( c == st.partitionings() );
+    assert( 0 < st.comparisons );
+    assert( st.max_depth < has.size() );
+    assert( st.max_depth + 1 == st.depth_ns.size() );
+}
+void test_qsort_stats(const std::string& prefix, const test_vector_t& has, const test_vector_t& exp) {
+    test_qsort_stats("qsort-stats-hoare_goth-"+prefix, hoare2::qsort, has, exp);
+    test_qsort_stats("qsort-stats-hoare_sedg-"+prefix, hoare1::qsort, has, exp);
+    test_qsort_stats("qsort-stats-hoare_tony-"+prefix, hoare0::qsort, has, exp);
+    test_qsort_stats("qsort-stats-lumoto____-"+prefix, lumoto::qsort, has, exp);
+    test_qsort_stats("qsort-stats-hoare_yaro-"+prefix, hoare3::qsort, has, exp);
+}
+
 int main() {
     {
         test_vector_t vec({ 1, 8, 3, 4, 2, 9, 5, 7, 0, 6 });
@@ -411,5 +222,61 @@ int main() {
         test_vector_t exp({ 4, 8 });
         test_qsort("set01", vec, exp);
     }
+    {
+        test_vector_t vec({ 1, 8, 3, 4, 2, 9, 5, 7, 0, 6 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_stats("set01", vec, exp);
+    }
+    {
+        test_vector_t vec({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_stats("set02", vec, exp);
+    }
+    {
+        test_vector_t vec({ 1, 8, 3, 4, 2, 9, 5, 7, 0, 6 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_generic("set01", vec, exp);
+    }
+    {
+        test_vector_t vec({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_generic("set02", vec, exp);
+    }
+    {
+        test_vector_t vec({ 1, 8, 3, 4, 2, 9, 5, 7, 0, 6 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_iterative("set01", vec, exp);
+    }
+    {
+        test_vector_t vec({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 });
+        test_vector_t exp({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 });
+        test_qsort_iterative("set02", vec, exp);
+    }
+    {
+        test_vector_t vec({ 8, 4 });
+        test_vector_t exp({ 4, 8 });
+        test_qsort_iterative("set01", vec, exp);
+    }
+    {
+        test_record_vector_t vec({ { 1, "a" }, { 8, "b" }, { 3, "c" }, { 4, "d" }, { 2, "e" }, { 9, "f" } });
+        test_record_vector_t exp({ { 9, "f" }, { 8, "b" }, { 4, "d" }, { 3, "c" }, { 2, "e" }, { 1, "a" } });
+        test_qsort_record("set03", vec, exp);
+    }
+    test_qsort_subrange();
+    {
+        std::vector<std::string> vec({ "www.example.com", "", "www.example.org", "a", "www.ex", "mail.example.com", "www.example.com/b", "www.example.com/a", "www.example.com" });
+        std::vector<std::string> exp({ "", "a", "mail.example.com", "www.ex", "www.example.com", "www.example.com", "www.example.com/a", "www.example.com/b", "www.example.org" });
+        test_qsort_strings("set04", vec, exp);
+    }
+    {
+        // beyond insertion sort threshold
+        std::vector<std::string> vec;
+        for(int i=99; i>=0; --i) {
+            vec.push_back("host"+std::to_string(i % 7)+".example.com/"+std::to_string(i));
+        }
+        std::vector<std::string> exp = vec;
+        std::sort(exp.begin(), exp.end());
+        test_qsort_strings("set05", vec, exp);
+    }
     return 0;
 }
@@ -0,0 +1,370 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 4.0 Benchmarking the quicksort variants
+//===============================================================================
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <span>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/qsort.hpp"
+
+/**
+ * Lesson 4.0 Benchmark of all qsort variants against std::sort.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes 1K .. 100M.
+ *
+ * Each benchmark is named `<variant> <distribution> <n>`,
+ * one `bench-csv,<name>,<n>,<mean_ns>,<ns_per_element>` line is printed per benchmark,
+ * see cpp_basics::BenchCSVListener.
+ */
+namespace bench_env {
+    typedef std::vector<int> vector_t;
+
+    /** Input distribution generator producing `n` elements */
+    typedef vector_t (*make_func)(size_t n);
+
+    constexpr static const uint32_t seed = 0x1234567;
+
+    vector_t make_uniform(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max());
+        vector_t v(n);
+        for(int& x : v) { x = dist(rng); }
+        return v;
+    }
+    vector_t make_sorted(size_t n) {
+        vector_t v(n);
+        for(size_t i=0; i<n; ++i) { v[i] = int(i); }
+        return v;
+    }
+    vector_t make_reversed(size_t n) {
+        vector_t v(n);
+        for(size_t i=0; i<n; ++i) { v[i] = int(n - i); }
+        return v;
+    }
+    /** Ascending runs of length sqrt(n) */
+    vector_t make_sawtooth(size_t n) {
+        const size_t period = std::max<size_t>(2, size_t(std::sqrt(double(n))));
+        vector_t v(n);
+        for(size_t i=0; i<n; ++i) { v[i] = int(i % period); }
+        return v;
+    }
+    /** Ascending first half, descending second half */
+    vector_t make_organpipe(size_t n) {
+        vector_t v(n);
+        for(size_t i=0; i<n; ++i) { v[i] = int( i < n/2 ? i : n - i ); }
+        return v;
+    }
+    /** Uniform random over 16 distinct values */
+    vector_t make_fewunique(size_t n) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> dist(0, 15);
+        vector_t v(n);
+        for(int& x : v) { x = dist(rng); }
+        return v;
+    }
+    /** Zipf distribution with exponent 1 over up to 64K ranks */
+    vector_t make_zipf(size_t n) {
+        const size_t ranks = std::max<size_t>(1, std::min<size_t>(n, 1U << 16));
+        std::vector<double> cdf(ranks);
+        double sum = 0;
+        for(size_t k=0; k<ranks; ++k) {
+            sum += 1.0 / double(k + 1);
+            cdf[k] = sum;
+        }
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> dist(0, sum);
+        vector_t v(n);
+        for(int& x : v) {
+            x = int( std::lower_bound(cdf.cbegin(), cdf.cend(), dist(rng)) - cdf.cbegin() );
+        }
+        return v;
+    }
+
+    struct distribution_t {
+        const char* name;
+        make_func make;
+        /** true if naive pivot selection degenerates to O(n^2) and recursion depth O(n) */
+        bool degenerate;
+    };
+    const distribution_t distributions[] = {
+        { "uniform",   make_uniform,   false },
+        { "sorted",    make_sorted,    true },
+        { "reversed",  make_reversed,  true },
+        { "sawtooth",  make_sawtooth,  true },
+        { "organpipe", make_organpipe, true },
+        { "fewunique", make_fewunique, true },
+        { "zipf",      make_zipf,      true },
+    };
+
+    typedef size_t (*sort_func)(vector_t& array);
+
+    size_t std_sort(vector_t& array) {
+        std::sort(array.begin(), array.end());
+        return 0;
+    }
+
+    /** Maximum size of degenerated cases, limiting O(n^2) runtime and O(n) recursion depth */
+    constexpr static const size_t degenerate_max_n = 10'000;
+
+    struct variant_t {
+        const char* name;
+        sort_func sort;
+        /** true if using a fixed position pivot, i.e. degenerates on presorted input */
+        bool naive_pivot;
+        /** maximum size for any input */
+        size_t max_n;
+    };
+    const variant_t variants[] = {
+        { "std_sort",    std_sort,       false, std::numeric_limits<size_t>::max() },
+        { "hoare_tony",  hoare0::qsort,  true,  std::numeric_limits<size_t>::max() },
+        { "hoare_sedg",  hoare1::qsort,  true,  std::numeric_limits<size_t>::max() },
+        { "lumoto",      lumoto::qsort,  true,  std::numeric_limits<size_t>::max() },
+        { "hoare_goth",  hoare2::qsort,  true,  100'000 }, // O(n) insert/erase per relocation
+        { "hoare_yaro",  hoare3::qsort,  true,  std::numeric_limits<size_t>::max() },
+    };
+
+    size_t max_n(const variant_t& v, const distribution_t& d) {
+        return v.naive_pivot && d.degenerate ? std::min(v.max_n, degenerate_max_n) : v.max_n;
+    }
+
+    /** Index, iterator and std::span based API of one qsort variant */
+    struct api_variant_t {
+        const char* name;
+        sort_func index;
+        sort_func iter;
+        sort_func span;
+        /** maximum size for any input */
+        size_t max_n;
+    };
+    const api_variant_t api_variants[] = {
+        { "hoare_tony", hoare0::qsort,
+          [](vector_t& a) { return hoare0::qsort(a.begin(), a.end()); },
+          [](vector_t& a) { return hoare0::qsort(std::span(a)); }, std::numeric_limits<size_t>::max() },
+        { "hoare_sedg", hoare1::qsort,
+          [](vector_t& a) { return hoare1::qsort(a.begin(), a.end()); },
+          [](vector_t& a) { return hoare1::qsort(std::span(a)); }, std::numeric_limits<size_t>::max() },
+        { "lumoto", lumoto::qsort,
+          [](vector_t& a) { return lumoto::qsort(a.begin(), a.end()); },
+          [](vector_t& a) { return lumoto::qsort(std::span(a)); }, std::numeric_limits<size_t>::max() },
+        { "hoare_goth", hoare2::qsort,
+          [](vector_t& a) { return hoare2::qsort(a.begin(), a.end()); },
+          [](vector_t& a) { return hoare2::qsort(std::span(a)); }, 100'000 },
+        { "hoare_yaro", hoare3::qsort,
+          [](vector_t& a) { return hoare3::qsort(a.begin(), a.end()); },
+          [](vector_t& a) { return hoare3::qsort(std::span(a)); }, std::numeric_limits<size_t>::max() },
+    };
+
+    typedef std::vector<std::string> string_vector_t;
+
+    /**
+     * URL-like strings `https://<host>.<domain>.<tld>/<path>/<id>`,
+     * sharing long common prefixes due to a limited pool of hosts and paths.
+     */
+    string_vector_t make_urls(size_t n) {
+        static const char* const hosts[] = { "www", "mail", "api", "cdn", "static", "login", "docs", "shop" };
+        static const char* const domains[] = { "example", "examplesoftware", "jausoft", "wikipedia", "kernel", "opensource" };
+        static const char* const tlds[] = { "com", "org", "net", "de", "io" };
+        static const char* const paths[] = { "index.html", "assets/img", "assets/css", "api/v1/users", "api/v1/items", "docs/manual", "" };
+        std::mt19937 rng(seed);
+        string_vector_t v(n);
+        for(std::string& s : v) {
+            s.append("https://").append(hosts[rng() % std::size(hosts)]).append(".")
+             .append(domains[rng() % std::size(domains)]).append(".").append(tlds[rng() % std::size(tlds)])
+             .append("/").append(paths[rng() % std::size(paths)]).append("/").append(std::to_string(rng() % 100'000));
+        }
+        return v;
+    }
+
+    typedef size_t (*string_sort_func)(string_vector_t& array);
+
+    const std::pair<const char*, string_sort_func> string_variants[] = {
+        { "std_sort",   [](string_vector_t& a) { std::sort(a.begin(), a.end()); return size_t(0); } },
+        { "hoare_yaro", hoare3::qsort },
+        { "multikey",   multikey::qsort },
+    };
+
+    /** Recursive and iterative form of one qsort variant */
+    struct loop_variant_t {
+        const char* name;
+        sort_func recursive;
+        sort_func iterative;
+        /** maximum size for any input */
+        size_t max_n;
+    };
+    const loop_variant_t loop_variants[] = {
+        { "hoare_tony", [](vector_t& a) { return hoare0::qsort(a.begin(), a.end()); }, hoare0::qsort_iterative, std::numeric_limits<size_t>::max() },
+        { "hoare_sedg", [](vector_t& a) { return hoare1::qsort(a.begin(), a.end()); }, hoare1::qsort_iterative, std::numeric_limits<size_t>::max() },
+        { "lumoto",     [](vector_t& a) { return lumoto::qsort(a.begin(), a.end()); }, lumoto::qsort_iterative, std::numeric_limits<size_t>::max() },
+        { "hoare_goth", [](vector_t& a) { return hoare2::qsort(a.begin(), a.end()); }, hoare2::qsort_iterative, 100'000 },
+        { "hoare_yaro", [](vector_t& a) { return hoare3::qsort(a.begin(), a.end()); }, hoare3::qsort_iterative, std::numeric_limits<size_t>::max() },
+    };
+
+    /** Small array sizes, where call overhead is most visible */
+    std::vector<size_t> small_sizes() {
+        if( catch_perf_analysis ) {
+            return { 8, 16, 32, 64, 128, 256, 1'024, 1'000'000 };
+        } else {
+            return { 16, 256 };
+        }
+    }
+
+    std::vector<size_t> sizes() {
+        if( catch_perf_analysis ) {
+            return { 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+        } else {
+            return { 1'000 };
+        }
+    }
+}
+
+TEST_CASE( "QSort Distributions Test 01", "[qsort][sort]" ) {
+    using namespace bench_env;
+    for(const distribution_t& d : distributions) {
+        for(size_t n : { 0, 1, 2, 3, 10, 100, 1000 }) {
+            const vector_t in = d.make(n);
+            vector_t exp = in;
+            std::sort(exp.begin(), exp.end());
+            for(const variant_t& v : variants) {
+                vector_t has = in;
+                v.sort(has);
+                REQUIRE_MSG(std::string(v.name)+" "+d.name+" "+std::to_string(n), exp == has);
+            }
+        }
+    }
+}
+
+TEST_CASE( "QSort Benchmark 01", "[qsort][sort][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        for(const distribution_t& d : distributions) {
+            const vector_t in = d.make(n);
+            for(const variant_t& v : variants) {
+                if( n > max_n(v, d) ) {
+                    continue;
+                }
+                BENCHMARK_ADVANCED(std::string(v.name)+" "+d.name+" "+std::to_string(n))(Catch::Benchmark::Chronometer meter) {
+                    std::vector<vector_t> data(size_t(meter.runs()), in);
+                    meter.measure([&](int i) { return v.sort(data[size_t(i)]); });
+                };
+            }
+        }
+    }
+}
+
+TEST_CASE( "QSort Generic API Test 01", "[qsort][sort]" ) {
+    using namespace bench_env;
+    for(const distribution_t& d : distributions) {
+        const vector_t in = d.make(1000);
+        vector_t exp = in;
+        std::sort(exp.begin(), exp.end());
+        for(const api_variant_t& v : api_variants) {
+            for(sort_func sort : { v.index, v.iter, v.span }) {
+                vector_t has = in;
+                sort(has);
+                REQUIRE_MSG(std::string(v.name)+" "+d.name, exp == has);
+            }
+        }
+    }
+}
+
+/**
+ * Index based API versus iterator and std::span based API,
+ * the latter shall show no regression.
+ */
+TEST_CASE( "QSort Benchmark 02 Generic API", "[qsort][sort][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        const vector_t in = make_uniform(n);
+        for(const api_variant_t& v : api_variants) {
+            if( n > v.max_n ) {
+                continue;
+            }
+            const std::pair<const char*, sort_func> apis[] = { { "index", v.index }, { "iter", v.iter }, { "span", v.span } };
+            for(const auto& [api, sort] : apis) {
+                BENCHMARK_ADVANCED(std::string(v.name)+" "+api+" uniform "+std::to_string(n))(Catch::Benchmark::Chronometer meter) {
+                    std::vector<vector_t> data(size_t(meter.runs()), in);
+                    meter.measure([&](int i) { return sort(data[size_t(i)]); });
+                };
+            }
+        }
+    }
+}
+
+TEST_CASE( "QSort Strings Test 01", "[qsort][sort][string]" ) {
+    using namespace bench_env;
+    for(size_t n : { 0, 1, 2, 10, 100, 1000, 10000 }) {
+        const string_vector_t in = make_urls(n);
+        string_vector_t exp = in;
+        std::sort(exp.begin(), exp.end());
+        for(const auto& [name, sort] : string_variants) {
+            string_vector_t has = in;
+            sort(has);
+            REQUIRE_MSG(std::string(name)+" "+std::to_string(n), exp == has);
+        }
+    }
+}
+
+/** Multikey quicksort versus hoare3 and std::sort on URL-like strings */
+TEST_CASE( "QSort Benchmark 03 Strings", "[qsort][sort][string][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : sizes()) {
+        if( n > 10'000'000 ) {
+            continue; // ~100 bytes per string
+        }
+        const string_vector_t in = make_urls(n);
+        for(const auto& [name, sort] : string_variants) {
+            BENCHMARK_ADVANCED(std::string(name)+" urls "+std::to_string(n))(Catch::Benchmark::Chronometer meter) {
+                std::vector<string_vector_t> data(size_t(meter.runs()), in);
+                meter.measure([&](int i) { return sort(data[size_t(i)]); });
+            };
+        }
+    }
+}
+
+TEST_CASE( "QSort Iterative Test 01", "[qsort][sort]" ) {
+    using namespace bench_env;
+    for(const distribution_t& d : distributions) {
+        for(size_t n : { 0, 1, 2, 3, 10, 100, 1000 }) {
+            const vector_t in = d.make(n);
+            vector_t exp = in;
+            std::sort(exp.begin(), exp.end());
+            for(const loop_variant_t& v : loop_variants) {
+                vector_t has = in;
+                v.iterative(has);
+                REQUIRE_MSG(std::string(v.name)+" "+d.name+" "+std::to_string(n), exp == has);
+            }
+        }
+    }
+}
+
+/** Recursive versus iterative qsort on small arrays, i.e. measuring the saved call overhead */
+TEST_CASE( "QSort Benchmark 04 Iterative", "[qsort][sort][benchmark]" ) {
+    using namespace bench_env;
+    for(size_t n : small_sizes()) {
+        const vector_t in = make_uniform(n);
+        for(const loop_variant_t& v : loop_variants) {
+            if( n > v.max_n ) {
+                continue;
+            }
+            const std::pair<const char*, sort_func> forms[] = { { "recursive", v.recursive }, { "iterative", v.iterative } };
+            for(const auto& [form, sort] : forms) {
+                BENCHMARK_ADVANCED(std::string(v.name)+" "+form+" uniform "+std::to_string(n))(Catch::Benchmark::Chronometer meter) {
+                    std::vector<vector_t> data(size_t(meter.runs()), in);
+                    meter.measure([&](int i) { return sort(data[size_t(i)]); });
+                };
+            }
+        }
+    }
+}
@@ -13,6 +13,8 @@
 
 #include <cassert>
 
+#include <cpp_basics/coro_frame_pool.hpp>
+
 //
 // https://www.scs.stanford.edu/~dm/blog/c++-coroutines.html
 //
@@ -146,7 +148,8 @@ namespace test_06 {
         struct promise_type;
         using handle_type = std::coroutine_handle<promise_type>;
 
-        struct promise_type {
+        // coroutine frame allocated from the thread-local coro::FramePool
+        struct promise_type : coro::pooled_frame {
             T value_;
             std::exception_ptr exception_;
 
@@ -204,9 +207,15 @@ namespace test_06 {
     }
 
     void test() {
-        auto gen = counter();
-        while( gen )
-            std::cout << "counter6: " << gen() << std::endl;
+        for(int j = 0; j < 2; ++j) {
+            auto gen = counter();
+            while( gen )
+                std::cout << "counter6: " << gen() << std::endl;
+        }
+        // 2nd frame reuses the 1st
+        const coro::frame_pool_stats& stats = coro::FramePool::local().stats();
+        std::cout << "frame pool: hits " << stats.hits << ", misses " << stats.misses << ", peak " << stats.peak << std::endl;
+        assert( 1 == stats.hits && 1 == stats.misses && 1 == stats.peak && 0 == stats.live );
     }
 }
 
@@ -0,0 +1,546 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking coroutines vs callbacks, std::function and threads
+//============================================================================
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_frame_pool.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of the basic coroutine mechanics of lesson51_coroutine1.cpp,
+ * each compared against equivalent callback, std::function and thread implementations.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> <cost> <n>` and performs `n` operations,
+ * i.e. the bench-csv ns_per_element column reports ns per operation, see cpp_basics::BenchCSVListener.
+ * Thread variants use fewer operations, being orders of magnitude slower.
+ *
+ * Costs
+ * - `resume`: resuming a coroutine suspended via the `test_01::Awaiter` pattern until it suspends again,
+ *   vs invoking a callback via function pointer or std::function
+ * - `yield`: one value pulled from the `test_06::Generator` pattern,
+ *   vs pushed to a callback or std::function, or handed over from a producer thread
+ * - `frame`: allocating and destroying a coroutine frame on the heap or coro::FramePool,
+ *   vs a heap allocated callback context, a std::function w/ capture beyond its small buffer, or a thread
+ * - `handoff`: round trip between two executor threads, continuing a coroutine, a callback or a std::function
+ *   posted to the other thread's queue, vs two threads taking turns directly
+ */
+namespace bench_env {
+    /** Prevents the compiler from optimizing away or seeing through the given object. */
+    template<typename T>
+    void sink(T& v) {
+        asm volatile("" : : "g"(&v) : "memory");
+    }
+
+    //
+    // resume
+    //
+
+    /** Eager coroutine w/o result, frame destroyed at completion. */
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept { }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    /** test_01::Awaiter */
+    struct Awaiter {
+        std::coroutine_handle<> *hp_;
+        constexpr bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { *hp_ = h; }
+        constexpr void await_resume() const noexcept { }
+    };
+
+    /** test_01::counter() w/o console output, completing after `n` resumptions. */
+    Detached counter(std::coroutine_handle<> *continuation_out, uint64_t& count, uint64_t n) {
+        Awaiter a{ continuation_out };
+        while( count < n ) {
+            co_await a;
+            ++count;
+        }
+    }
+
+    uint64_t coroutine_resume(uint64_t n) {
+        uint64_t count = 0;
+        std::coroutine_handle<> h;
+        counter(&h, count, n);
+        for(uint64_t i = 0; i < n; ++i) {
+            h.resume();
+        }
+        return count;
+    }
+
+    struct callback_t {
+        void (*fn)(void*);
+        void* ctx;
+    };
+
+    void increment(void* ctx) { ++*static_cast<uint64_t*>(ctx); }
+
+    uint64_t callback_resume(uint64_t n) {
+        uint64_t count = 0;
+        callback_t cb{ increment, &count };
+        sink(cb); // opaque, as a stored callback
+        for(uint64_t i = 0; i < n; ++i) {
+            cb.fn(cb.ctx);
+        }
+        return count;
+    }
+
+    uint64_t std_function_resume(uint64_t n) {
+        uint64_t count = 0;
+        std::function<void()> f = [&count]() { ++count; };
+        sink(f);
+        for(uint64_t i = 0; i < n; ++i) {
+            f();
+        }
+        return count;
+    }
+
+    //
+    // yield
+    //
+
+    /** test_06::Generator w/o console output */
+    template <typename T>
+    struct Generator {
+        struct promise_type;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct promise_type : coro::pooled_frame {
+            T value_;
+            std::exception_ptr exception_;
+
+            Generator get_return_object() {
+                return Generator(handle_type::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void unhandled_exception() { exception_ = std::current_exception(); }
+            template <std::convertible_to<T> From>  // C++20 concept
+            std::suspend_always yield_value(From &&from) {
+                value_ = std::forward<From>(from);
+                return {};
+            }
+            void return_void() { }
+        };
+
+        handle_type h_;
+
+        Generator(handle_type h): h_(h) { }
+        Generator(const Generator &) = delete;
+        ~Generator() { h_.destroy(); }
+        explicit operator bool() {
+            fill();
+            return !h_.done();
+        }
+        T operator()() {
+            fill();
+            full_ = false;
+            return std::move(h_.promise().value_);
+        }
+
+      private:
+        bool full_ = false;
+
+        void fill() {
+            if( !full_ ) {
+                h_();
+                if( h_.promise().exception_ )
+                    std::rethrow_exception(h_.promise().exception_);
+                full_ = true;
+            }
+        }
+    };
+
+    Generator<uint64_t> numbers(uint64_t n) {
+        for(uint64_t i = 0; i < n; ++i) {
+            co_yield i;
+        }
+    }
+
+    uint64_t coroutine_yield(uint64_t n) {
+        uint64_t sum = 0;
+        auto gen = numbers(n);
+        while( gen ) {
+            sum += gen();
+        }
+        return sum;
+    }
+
+    void produce(uint64_t n, void (*fn)(void*, uint64_t), void* ctx) {
+        for(uint64_t i = 0; i < n; ++i) {
+            fn(ctx, i);
+        }
+    }
+
+    void add(void* ctx, uint64_t v) { *static_cast<uint64_t*>(ctx) += v; }
+
+    uint64_t callback_yield(uint64_t n) {
+        uint64_t sum = 0;
+        void (*fn)(void*, uint64_t) = add;
+        sink(fn);
+        produce(n, fn, &sum);
+        return sum;
+    }
+
+    uint64_t std_function_yield(uint64_t n) {
+        uint64_t sum = 0;
+        std::function<void(uint64_t)> f = [&sum](uint64_t v) { sum += v; };
+        sink(f);
+        for(uint64_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return sum;
+    }
+
+    /** Producer thread handing over each value via a single slot, i.e. a blocking generator. */
+    uint64_t thread_yield(uint64_t n) {
+        std::mutex mtx;
+        std::condition_variable cv;
+        uint64_t slot = 0;
+        bool full = false;
+        std::thread producer([&]() {
+            for(uint64_t i = 0; i < n; ++i) {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]{ return !full; });
+                slot = i;
+                full = true;
+                cv.notify_all();
+            }
+        });
+        uint64_t sum = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]{ return full; });
+            sum += slot;
+            full = false;
+            cv.notify_all();
+        }
+        producer.join();
+        return sum;
+    }
+
+    //
+    // frame
+    //
+
+    /** Lazy coroutine only holding its frame, allocated via `FrameAlloc`. */
+    template<typename FrameAlloc>
+    struct FrameOnly {
+        struct promise_type : FrameAlloc {
+            FrameOnly get_return_object() noexcept { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() noexcept { }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+        std::coroutine_handle<promise_type> h;
+    };
+
+    /** Eight captured words, exceeding the std::function small buffer */
+    struct capture_t {
+        uint64_t v[8];
+    };
+
+    template<typename FrameAlloc>
+    FrameOnly<FrameAlloc> frame_only(capture_t c) {
+        sink(c);
+        co_return;
+    }
+
+    template<typename FrameAlloc>
+    uint64_t coroutine_frame(uint64_t n) {
+        uint64_t count = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            FrameOnly<FrameAlloc> f = frame_only<FrameAlloc>(capture_t{ { i } });
+            count += f.h ? 1 : 0;
+            f.h.destroy();
+        }
+        return count;
+    }
+
+    uint64_t callback_frame(uint64_t n) {
+        uint64_t count = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            std::unique_ptr<capture_t> ctx = std::make_unique<capture_t>(capture_t{ { i } });
+            sink(ctx);
+            count += ctx ? 1 : 0;
+        }
+        return count;
+    }
+
+    uint64_t std_function_frame(uint64_t n) {
+        uint64_t count = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            std::function<uint64_t()> f = [c = capture_t{ { i } }]() { return c.v[0]; };
+            sink(f);
+            count += f ? 1 : 0;
+        }
+        return count;
+    }
+
+    uint64_t thread_frame(uint64_t n) {
+        uint64_t count = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            std::thread t([&count]() { ++count; });
+            t.join();
+        }
+        return count;
+    }
+
+    //
+    // handoff
+    //
+
+    /** Thread running the items posted to its queue in order. */
+    template<typename Item>
+    class Executor {
+      private:
+        std::mutex m_mtx;
+        std::condition_variable m_cv;
+        std::deque<Item> m_queue;
+        bool m_stop = false;
+        std::thread m_thread;
+
+        void run() {
+            while( true ) {
+                Item item;
+                {
+                    std::unique_lock<std::mutex> lock(m_mtx);
+                    m_cv.wait(lock, [&]{ return m_stop || !m_queue.empty(); });
+                    if( m_queue.empty() ) {
+                        return;
+                    }
+                    item = std::move(m_queue.front());
+                    m_queue.pop_front();
+                }
+                item();
+            }
+        }
+
+      public:
+        Executor() : m_thread(&Executor::run, this) { }
+        ~Executor() {
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_stop = true;
+            }
+            m_cv.notify_one();
+            m_thread.join();
+        }
+
+        void post(Item item) {
+            {
+                std::lock_guard<std::mutex> lock(m_mtx);
+                m_queue.push_back(std::move(item));
+            }
+            m_cv.notify_one();
+        }
+    };
+
+    /** Completion flag awaited by the benchmark's thread */
+    struct done_flag {
+        std::atomic<bool> done = false;
+
+        void set() {
+            done.store(true);
+            done.notify_one();
+        }
+        void wait() {
+            done.wait(false);
+        }
+    };
+
+    typedef Executor<std::coroutine_handle<>> coro_executor;
+
+    /** Suspends and continues the awaiting coroutine on the given executor's thread */
+    struct switch_to {
+        coro_executor& ex;
+        constexpr bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { ex.post(h); }
+        constexpr void await_resume() const noexcept { }
+    };
+
+    Detached ping_pong(coro_executor& a, coro_executor& b, uint64_t n, uint64_t& count, done_flag& done) {
+        for(uint64_t i = 0; i < n; ++i) {
+            co_await switch_to{b};
+            co_await switch_to{a};
+            ++count;
+        }
+        done.set();
+    }
+
+    uint64_t coroutine_handoff(uint64_t n) {
+        uint64_t count = 0;
+        done_flag done; // outlives the executors, still notifying
+        {
+            coro_executor a, b;
+            ping_pong(a, b, n, count, done); // starts on the calling thread, continues on b and a
+            done.wait();
+        }
+        return count;
+    }
+
+    struct callback_item {
+        void (*fn)(void*) = nullptr;
+        void* ctx = nullptr;
+        void operator()() const { fn(ctx); }
+    };
+
+    /** Callback state machine of ping_pong() */
+    struct callback_ping_pong {
+        Executor<callback_item>& a;
+        Executor<callback_item>& b;
+        uint64_t n;
+        done_flag& done;
+        uint64_t count = 0;
+
+        static void on_b(void* ctx) {
+            callback_ping_pong& s = *static_cast<callback_ping_pong*>(ctx);
+            s.a.post({ on_a, ctx });
+        }
+        static void on_a(void* ctx) {
+            callback_ping_pong& s = *static_cast<callback_ping_pong*>(ctx);
+            if( ++s.count < s.n ) {
+                s.b.post({ on_b, ctx });
+            } else {
+                s.done.set();
+            }
+        }
+    };
+
+    uint64_t callback_handoff(uint64_t n) {
+        done_flag done; // outlives the executors, still notifying
+        Executor<callback_item> a, b;
+        callback_ping_pong s{ a, b, n, done };
+        b.post({ callback_ping_pong::on_b, &s });
+        done.wait();
+        return s.count;
+    }
+
+    struct std_function_ping_pong {
+        Executor<std::function<void()>>& a;
+        Executor<std::function<void()>>& b;
+        uint64_t n;
+        done_flag& done;
+        uint64_t count = 0;
+
+        void on_b() { a.post([this]() { on_a(); }); }
+        void on_a() {
+            if( ++count < n ) {
+                b.post([this]() { on_b(); });
+            } else {
+                done.set();
+            }
+        }
+    };
+
+    uint64_t std_function_handoff(uint64_t n) {
+        done_flag done; // outlives the executors, still notifying
+        Executor<std::function<void()>> a, b;
+        std_function_ping_pong s{ a, b, n, done };
+        b.post([&s]() { s.on_b(); });
+        done.wait();
+        return s.count;
+    }
+
+    /** Two threads taking turns directly, w/o executor queues */
+    uint64_t thread_handoff(uint64_t n) {
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool b_turn = false;
+        uint64_t count = 0;
+        std::thread b([&]() {
+            for(uint64_t i = 0; i < n; ++i) {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&]{ return b_turn; });
+                b_turn = false;
+                cv.notify_one();
+            }
+        });
+        for(uint64_t i = 0; i < n; ++i) {
+            std::unique_lock<std::mutex> lock(mtx);
+            b_turn = true;
+            cv.notify_one();
+            cv.wait(lock, [&]{ return !b_turn; });
+            ++count;
+        }
+        b.join();
+        return count;
+    }
+
+    uint64_t op_count() {
+        return catch_perf_analysis ? 10'000'000 : 100'000;
+    }
+    uint64_t thread_op_count() {
+        return catch_perf_analysis ? 100'000 : 1'000;
+    }
+}
+
+TEST_CASE( "Coroutine Cost Benchmark 01", "[coroutine][benchmark]" ) {
+    using namespace bench_env;
+    const uint64_t n = op_count();
+    const uint64_t tn = thread_op_count();
+    const std::string sn = std::to_string(n);
+    const std::string stn = std::to_string(tn);
+
+    REQUIRE( n == coroutine_resume(n) );
+    REQUIRE( n == callback_resume(n) );
+    REQUIRE( n == std_function_resume(n) );
+    BENCHMARK("coroutine resume "+sn) { return coroutine_resume(n); };
+    BENCHMARK("callback resume "+sn) { return callback_resume(n); };
+    BENCHMARK("std_function resume "+sn) { return std_function_resume(n); };
+
+    const uint64_t sum_n = n * (n - 1) / 2;
+    REQUIRE( sum_n == coroutine_yield(n) );
+    REQUIRE( sum_n == callback_yield(n) );
+    REQUIRE( sum_n == std_function_yield(n) );
+    REQUIRE( tn * (tn - 1) / 2 == thread_yield(tn) );
+    BENCHMARK("coroutine yield "+sn) { return coroutine_yield(n); };
+    BENCHMARK("callback yield "+sn) { return callback_yield(n); };
+    BENCHMARK("std_function yield "+sn) { return std_function_yield(n); };
+    BENCHMARK("thread yield "+stn) { return thread_yield(tn); };
+
+    REQUIRE( n == coroutine_frame<coro::heap_frame>(n) );
+    REQUIRE( n == coroutine_frame<coro::pooled_frame>(n) );
+    REQUIRE( n == callback_frame(n) );
+    REQUIRE( n == std_function_frame(n) );
+    REQUIRE( tn == thread_frame(tn) );
+    BENCHMARK("coroutine_heap frame "+sn) { return coroutine_frame<coro::heap_frame>(n); };
+    BENCHMARK("coroutine_pool frame "+sn) { return coroutine_frame<coro::pooled_frame>(n); };
+    BENCHMARK("callback frame "+sn) { return callback_frame(n); };
+    BENCHMARK("std_function frame "+sn) { return std_function_frame(n); };
+    BENCHMARK("thread frame "+stn) { return thread_frame(tn); };
+
+    REQUIRE( tn == coroutine_handoff(tn) );
+    REQUIRE( tn == callback_handoff(tn) );
+    REQUIRE( tn == std_function_handoff(tn) );
+    REQUIRE( tn == thread_handoff(tn) );
+    BENCHMARK("coroutine handoff "+stn) { return coroutine_handoff(tn); };
+    BENCHMARK("callback handoff "+stn) { return callback_handoff(tn); };
+    BENCHMARK("std_function handoff "+stn) { return std_function_handoff(tn); };
+    BENCHMARK("thread handoff "+stn) { return thread_handoff(tn); };
+}
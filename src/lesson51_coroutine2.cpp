@@ -0,0 +1,175 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine Task<T> and work-stealing scheduler
+//============================================================================
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+
+/**
+ * Lesson 5.1 Coroutine Task<T> awaited via symmetric transfer,
+ * spawned onto the multi-threaded coro::WorkStealingScheduler.
+ */
+namespace test_env {
+    coro::Task<int> value(int v) {
+        co_return v;
+    }
+
+    coro::Task<int> sum(int a, int b) {
+        const int x = co_await value(a);
+        const int y = co_await value(b);
+        co_return x + y;
+    }
+
+    coro::Task<int> fail() {
+        throw std::runtime_error("fail");
+        co_return 0;
+    }
+
+    /** Awaits a chain of `depth` nested tasks, growing the stack w/o symmetric transfer. */
+    coro::Task<uint64_t> chain(size_t depth) {
+        if( 0 == depth ) {
+            co_return 0;
+        }
+        co_return 1 + co_await chain(depth - 1);
+    }
+
+    /** Completes a chain of `n` tasks synchronously, each resuming its awaiting coroutine. */
+    coro::Task<void> nop() {
+        co_return;
+    }
+
+    coro::Task<uint64_t> loop(size_t n) {
+        uint64_t count = 0;
+        for(size_t i = 0; i < n; ++i) {
+            co_await nop();
+            ++count;
+        }
+        co_return count;
+    }
+
+    coro::Task<std::thread::id> thread_id() {
+        co_return std::this_thread::get_id();
+    }
+
+    /** Recursive fork-join fibonacci, spawning both halves. */
+    coro::Task<uint64_t> fib(coro::WorkStealingScheduler& sched, unsigned n) {
+        if( n < 2 ) {
+            co_return n;
+        }
+        auto a = sched.spawn(fib(sched, n - 1));
+        auto b = sched.spawn(fib(sched, n - 2));
+        const uint64_t x = co_await a;
+        const uint64_t y = co_await b;
+        co_return x + y;
+    }
+}
+
+TEST_CASE( "Coroutine Task Test 01", "[coroutine][task]" ) {
+    using namespace test_env;
+
+    REQUIRE( 42 == coro::sync_wait(value(42)) );
+    REQUIRE( 5 == coro::sync_wait(sum(2, 3)) );
+    REQUIRE_THROWS_AS( coro::sync_wait(fail()), std::runtime_error );
+
+    {
+        coro::Task<int> t = value(1);
+        REQUIRE( false == t.done() ); // lazy
+        REQUIRE( 1 == coro::sync_wait(std::move(t)) );
+    }
+
+    // symmetric transfer: neither deep chains nor long loops grow the stack
+    REQUIRE( 100'000 == coro::sync_wait(chain(100'000)) );
+    REQUIRE( 1'000'000 == coro::sync_wait(loop(1'000'000)) );
+}
+
+TEST_CASE( "Coroutine Scheduler Test 01", "[coroutine][scheduler]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(4);
+    REQUIRE( 4 == sched.size() );
+    REQUIRE( false == sched.on_worker() );
+
+    // spawned tasks run on a worker thread
+    {
+        auto h = sched.spawn(thread_id());
+        REQUIRE( std::this_thread::get_id() != h.join() );
+    }
+    {
+        auto h = sched.spawn(sum(20, 22));
+        REQUIRE( 42 == h.join() );
+        REQUIRE( true == h.done() );
+    }
+    {
+        auto h = sched.spawn(fail());
+        REQUIRE_THROWS_AS( h.join(), std::runtime_error );
+    }
+    // join via co_await
+    {
+        bool on_worker = false;
+        auto outer = [&]() -> coro::Task<int> {
+            co_await sched.schedule();
+            on_worker = sched.on_worker();
+            auto h = sched.spawn(value(7));
+            co_return 1 + co_await h;
+        };
+        REQUIRE( 8 == coro::sync_wait(outer()) );
+        REQUIRE( true == on_worker );
+    }
+    // detached tasks complete before the scheduler is destructed
+    std::atomic<size_t> counter = 0;
+    {
+        coro::WorkStealingScheduler s2(2);
+        auto incr = [&]() -> coro::Task<void> {
+            counter.fetch_add(1);
+            co_return;
+        };
+        for(size_t i = 0; i < 1000; ++i) {
+            (void)s2.spawn(incr());
+        }
+    }
+    REQUIRE( 1000 == counter.load() );
+}
+
+TEST_CASE( "Coroutine Scheduler Test 02", "[coroutine][scheduler][steal]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(4);
+
+    // fork-join recursion spawns from worker threads onto their local deques
+    REQUIRE( 6765 == sched.spawn(fib(sched, 20)).join() );
+
+    // tasks spawned from one worker are stolen by the others,
+    // blocking each task briefly to let idle workers steal
+    std::atomic<size_t> running = 0;
+    std::atomic<size_t> max_running = 0;
+    auto work = [&]() -> coro::Task<void> {
+        const size_t r = running.fetch_add(1) + 1;
+        size_t m = max_running.load();
+        while( r > m && !max_running.compare_exchange_weak(m, r) ) { }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        running.fetch_sub(1);
+        co_return;
+    };
+    auto root = [&]() -> coro::Task<void> {
+        std::vector<coro::JoinHandle<void>> hs;
+        for(size_t i = 0; i < 64; ++i) {
+            hs.push_back(sched.spawn(work()));
+        }
+        for(coro::JoinHandle<void>& h : hs) {
+            co_await h;
+        }
+    };
+    sched.spawn(root()).join();
+    REQUIRE( 0 < sched.steal_count() );
+    REQUIRE( 1 < max_running.load() );
+}
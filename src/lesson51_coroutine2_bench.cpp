@@ -0,0 +1,123 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking the coroutine work-stealing scheduler
+//============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of coro::WorkStealingScheduler spawn/await throughput by number of worker threads.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> threads <t> tasks <n>` and completes `n` tasks,
+ * i.e. the bench-csv ns_per_element column reports ns per task, see cpp_basics::BenchCSVListener.
+ * A final tasks/sec summary per thread count is emitted via WARN.
+ *
+ * Variants
+ * - `spawn_await`: one root task spawns all `n` tasks from a worker, then awaits each, i.e. idle workers must steal
+ * - `fork_join`: recursive binary fork-join, spawning from all workers
+ */
+namespace bench_env {
+    coro::Task<uint64_t> leaf(uint64_t v) {
+        co_return v;
+    }
+
+    coro::Task<uint64_t> spawn_await(coro::WorkStealingScheduler& sched, size_t n) {
+        std::vector<coro::JoinHandle<uint64_t>> hs;
+        hs.reserve(n);
+        for(size_t i = 0; i < n; ++i) {
+            hs.push_back(sched.spawn(leaf(i)));
+        }
+        uint64_t sum = 0;
+        for(coro::JoinHandle<uint64_t>& h : hs) {
+            sum += co_await h;
+        }
+        co_return sum;
+    }
+
+    /** Spawns `n - 1` tasks as binary fork-join tree, completing `n` tasks including itself. */
+    coro::Task<uint64_t> fork_join(coro::WorkStealingScheduler& sched, size_t n) {
+        if( n <= 1 ) {
+            co_return 1;
+        }
+        const size_t l = (n - 1) / 2;
+        const size_t r = n - 1 - l; // r >= 1
+        auto b = sched.spawn(fork_join(sched, r));
+        uint64_t c = 1;
+        if( 0 < l ) {
+            auto a = sched.spawn(fork_join(sched, l));
+            c += co_await a;
+        }
+        c += co_await b;
+        co_return c;
+    }
+
+    std::vector<size_t> thread_counts() {
+        const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<size_t> res;
+        for(size_t t = 1; t < hw; t *= 2) {
+            res.push_back(t);
+        }
+        res.push_back(hw);
+        if( !catch_perf_analysis && 1 == hw ) {
+            res.push_back(2); // cover stealing
+        }
+        return res;
+    }
+
+    size_t task_count() {
+        return catch_perf_analysis ? 1'000'000 : 10'000;
+    }
+}
+
+TEST_CASE( "Coroutine Scheduler Benchmark 01", "[coroutine][scheduler][benchmark]" ) {
+    using namespace bench_env;
+    const size_t n = task_count();
+    const std::string sn = std::to_string(n);
+    for(size_t t : thread_counts()) {
+        coro::WorkStealingScheduler sched(t);
+        const std::string prefix = " threads "+std::to_string(t)+" tasks "+sn;
+
+        BENCHMARK("spawn_await"+prefix) {
+            return sched.spawn(spawn_await(sched, n)).join();
+        };
+        BENCHMARK("fork_join"+prefix) {
+            return sched.spawn(fork_join(sched, n)).join();
+        };
+    }
+
+    // tasks/sec summary of single timed runs
+    std::string summary = "tasks/sec by worker threads, "+sn+" tasks\n";
+    for(size_t t : thread_counts()) {
+        coro::WorkStealingScheduler sched(t);
+        auto t0 = std::chrono::steady_clock::now();
+        const uint64_t s0 = sched.spawn(spawn_await(sched, n)).join();
+        auto t1 = std::chrono::steady_clock::now();
+        const uint64_t c1 = sched.spawn(fork_join(sched, n)).join();
+        auto t2 = std::chrono::steady_clock::now();
+        REQUIRE( uint64_t(n) * (n - 1) / 2 == s0 );
+        REQUIRE( n == c1 );
+
+        const double d0 = std::chrono::duration<double>(t1 - t0).count();
+        const double d1 = std::chrono::duration<double>(t2 - t1).count();
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "- threads %2zu: spawn_await %12.0f, fork_join %12.0f, steals %zu\n",
+                      t, double(n) / d0, double(n) / d1, sched.steal_count());
+        summary += buf;
+    }
+    WARN(summary);
+}
@@ -0,0 +1,336 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine Generator<T> and frame pool
+//============================================================================
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_frame_pool.hpp"
+#include "cpp_basics/coro_generator.hpp"
+#include "cpp_basics/coro_views.hpp"
+
+/**
+ * Lesson 5.1 Coroutine Generator<T>, derived from lesson51_coroutine1 `test_06::Generator`,
+ * allocating its frames from the thread-local coro::FramePool.
+ */
+namespace test_env {
+    template<typename FrameAlloc = coro::pooled_frame>
+    coro::Generator<unsigned, FrameAlloc> counter(unsigned n) {
+        for( unsigned i = 0; i < n; ) {
+            co_yield i++;
+        }
+    }
+
+    /** Frame exceeding coro::FramePool::max_frame_size */
+    coro::Generator<unsigned> large() {
+        volatile std::byte buf[2*coro::FramePool::max_frame_size];
+        buf[0] = std::byte(1);
+        co_yield unsigned(buf[0]);
+        co_yield unsigned(buf[sizeof(buf)-1]);
+    }
+
+    coro::Generator<unsigned> fail() {
+        co_yield 1;
+        throw std::runtime_error("fail");
+    }
+
+    /** Yields `[0..depth]`, each level nesting the remainder. */
+    coro::Generator<unsigned> nested(unsigned level, unsigned depth) {
+        co_yield level;
+        if( level < depth ) {
+            co_yield coro::elements_of(nested(level + 1, depth));
+        }
+    }
+
+    coro::Generator<unsigned> nested_fail() {
+        co_yield 1;
+        co_yield coro::elements_of(fail());
+        co_yield 3; // not reached
+    }
+
+    coro::Generator<unsigned> nested_catch() {
+        bool caught = false;
+        try {
+            co_yield coro::elements_of(fail());
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        co_yield caught ? 2 : 0;
+        auto inner = counter(2); // lvalue, referenced
+        co_yield coro::elements_of(inner);
+        co_yield coro::elements_of(counter(0));
+    }
+
+    /** Counts its resumptions, i.e. the values pulled */
+    coro::Generator<unsigned> counted(unsigned n, unsigned& pulled) {
+        for( unsigned i = 0; i < n; ++i ) {
+            ++pulled;
+            co_yield i;
+        }
+    }
+
+    template<typename G>
+    std::vector<unsigned> collect(G&& gen) {
+        std::vector<unsigned> res;
+        while( gen ) {
+            res.push_back(gen());
+        }
+        return res;
+    }
+}
+
+TEST_CASE( "Coroutine Generator Test 01", "[coroutine][generator]" ) {
+    using namespace test_env;
+
+    REQUIRE( std::vector<unsigned>{ 0, 1, 2 } == collect(counter(3)) );
+    REQUIRE( std::vector<unsigned>{ } == collect(counter(0)) );
+    REQUIRE( std::vector<unsigned>{ 0, 1, 2 } == collect(counter<coro::heap_frame>(3)) );
+    {
+        auto gen = fail();
+        REQUIRE( true == bool(gen) );
+        REQUIRE( 1 == gen() );
+        REQUIRE_THROWS_AS( bool(gen), std::runtime_error );
+        REQUIRE( false == bool(gen) );
+    }
+    {
+        auto a = counter(2);
+        auto b = std::move(a);
+        REQUIRE( std::vector<unsigned>{ 0, 1 } == collect(b) );
+    }
+}
+
+TEST_CASE( "Coroutine Frame Pool Test 01", "[coroutine][generator][pool]" ) {
+    using namespace test_env;
+    coro::FramePool& pool = coro::FramePool::local();
+    pool.trim();
+    pool.reset_stats();
+
+    // first frame is a miss, the following ones reuse it
+    for(int i = 0; i < 10; ++i) {
+        REQUIRE( 3 == collect(counter(3)).size() );
+    }
+    REQUIRE( 1 == pool.stats().misses );
+    REQUIRE( 9 == pool.stats().hits );
+    REQUIRE( 1 == pool.stats().peak );
+    REQUIRE( 0 == pool.stats().live );
+    REQUIRE( 1 == pool.cached() );
+
+    // peak of concurrently live frames
+    {
+        std::vector<coro::Generator<unsigned>> gens;
+        for(int i = 0; i < 5; ++i) {
+            gens.push_back(counter(1));
+        }
+        REQUIRE( 5 == pool.stats().live );
+        REQUIRE( 5 == pool.stats().peak );
+        REQUIRE( 1 + 4 == pool.stats().misses );
+    }
+    REQUIRE( 0 == pool.stats().live );
+    REQUIRE( 5 == pool.cached() );
+
+    // unpooled frames bypass the pool
+    pool.reset_stats();
+    REQUIRE( 3 == collect(counter<coro::heap_frame>(3)).size() );
+    REQUIRE( 0 == pool.stats().hits + pool.stats().misses );
+
+    // oversized frames are misses and not cached
+    REQUIRE( 2 == collect(large()).size() );
+    REQUIRE( 1 == pool.stats().misses );
+    REQUIRE( 5 == pool.cached() );
+
+    pool.trim();
+    REQUIRE( 0 == pool.cached() );
+
+    // each thread has its own pool
+    std::thread t([]() {
+        (void)collect(counter(3));
+    });
+    t.join();
+    REQUIRE( 1 == pool.stats().misses );
+}
+
+TEST_CASE( "Coroutine Frame Arena Test 01", "[coroutine][generator][pool][arena]" ) {
+    using namespace test_env;
+    coro::FramePool& pool = coro::FramePool::local();
+    pool.trim();
+    pool.reset_stats();
+
+    alignas(std::max_align_t) static std::byte buffer[4096];
+    {
+        coro::FrameArena arena(buffer, sizeof(buffer));
+        REQUIRE( sizeof(buffer) == arena.size() );
+        {
+            auto g1 = counter(3);
+            auto g2 = counter(3);
+            REQUIRE( 0 < arena.used() );
+            REQUIRE( 2 == pool.stats().hits );
+            REQUIRE( 0 == pool.stats().misses );
+            REQUIRE( std::vector<unsigned>{ 0, 1, 2 } == collect(g1) );
+        }
+        // freed arena frames are reused by the arena, not cached by the pool
+        const size_t used = arena.used();
+        for(int i = 0; i < 10; ++i) {
+            REQUIRE( 3 == collect(counter(3)).size() );
+        }
+        REQUIRE( used == arena.used() );
+        REQUIRE( 0 == pool.stats().misses );
+        REQUIRE( 0 == pool.cached() );
+
+        // exhausted arena falls back to the pool
+        std::vector<coro::Generator<unsigned>> gens;
+        while( arena.used() + coro::FramePool::max_frame_size <= arena.size() ) {
+            gens.push_back(counter(1));
+        }
+        for(int i = 0; i < 8; ++i) {
+            gens.push_back(counter(1));
+        }
+        REQUIRE( 0 < pool.stats().misses );
+    }
+    REQUIRE( 0 == pool.stats().live );
+}
+
+TEST_CASE( "Coroutine Generator Nested Test 01", "[coroutine][generator][nested]" ) {
+    using namespace test_env;
+
+    REQUIRE( std::vector<unsigned>{ 0, 1, 2, 3 } == collect(nested(0, 3)) );
+    {
+        const std::vector<unsigned> v = collect(nested(0, 100'000));
+        REQUIRE( 100'001 == v.size() );
+        REQUIRE( 100'000 == v.back() );
+    }
+    {
+        auto gen = nested_fail();
+        REQUIRE( 1 == gen() );
+        REQUIRE( 1 == gen() );
+        REQUIRE_THROWS_AS( bool(gen), std::runtime_error );
+        REQUIRE( false == bool(gen) );
+    }
+    REQUIRE( std::vector<unsigned>{ 1, 2, 0, 1 } == collect(nested_catch()) );
+    {
+        // abandoning a nested generator destroys all its frames
+        coro::FramePool& pool = coro::FramePool::local();
+        const ptrdiff_t live = pool.stats().live;
+        {
+            auto gen = nested(0, 100);
+            for(int i = 0; i < 50; ++i) {
+                (void)gen();
+            }
+            REQUIRE( live + 50 <= pool.stats().live );
+        }
+        REQUIRE( live == pool.stats().live );
+    }
+}
+
+TEST_CASE( "Coroutine Generator Range Test 01", "[coroutine][generator][range]" ) {
+    using namespace test_env;
+    typedef coro::Generator<unsigned> gen_t;
+    static_assert( std::ranges::input_range<gen_t> );
+    static_assert( std::ranges::view<gen_t> );
+    static_assert( std::input_iterator<std::ranges::iterator_t<gen_t>> );
+
+    {
+        std::vector<unsigned> v;
+        for(unsigned i : counter(4)) {
+            v.push_back(i);
+        }
+        REQUIRE( std::vector<unsigned>{ 0, 1, 2, 3 } == v );
+    }
+    {
+        unsigned sum = 0;
+        std::ranges::for_each(counter(4), [&](unsigned i) { sum += i; });
+        REQUIRE( 6 == sum );
+    }
+    {
+        auto gen = counter(10);
+        REQUIRE( 7 == *std::ranges::find(gen, 7u) );
+    }
+    {
+        std::vector<unsigned> v;
+        std::ranges::copy(nested(0, 3), std::back_inserter(v));
+        REQUIRE( std::vector<unsigned>{ 0, 1, 2, 3 } == v );
+    }
+    // interoperability with std::views
+    {
+        std::vector<unsigned> v;
+        for(unsigned i : counter(10) | std::views::transform([](unsigned x) { return x * x; }) | std::views::take(3)) {
+            v.push_back(i);
+        }
+        REQUIRE( std::vector<unsigned>{ 0, 1, 4 } == v );
+    }
+    {
+        auto gen = fail();
+        auto it = gen.begin();
+        REQUIRE( 1 == *it );
+        REQUIRE_THROWS_AS( ++it, std::runtime_error );
+    }
+}
+
+TEST_CASE( "Coroutine Generator Views Test 01", "[coroutine][generator][range][views]" ) {
+    using namespace test_env;
+    auto is_even = [](unsigned v) { return 0 == v % 2; };
+    auto triple = [](unsigned v) { return 3 * v; };
+
+    {
+        std::vector<unsigned> v;
+        for(unsigned i : counter(10) | coro::views::filter(is_even) | coro::views::transform(triple)) {
+            v.push_back(i);
+        }
+        REQUIRE( std::vector<unsigned>{ 0, 6, 12, 18, 24 } == v );
+    }
+    {
+        auto pipeline = counter(100) | coro::views::filter(is_even) | coro::views::transform(triple) | coro::views::take(3);
+        static_assert( std::ranges::input_range<decltype(pipeline)> );
+        static_assert( std::ranges::view<decltype(pipeline)> );
+        std::vector<unsigned> v;
+        std::ranges::copy(pipeline, std::back_inserter(v));
+        REQUIRE( std::vector<unsigned>{ 0, 6, 12 } == v );
+    }
+    // take() doesn't resume beyond the n-th value
+    {
+        unsigned pulled = 0;
+        REQUIRE( 3 == std::ranges::distance(counted(100, pulled) | coro::views::take(3)) );
+        REQUIRE( 3 == pulled );
+        pulled = 0;
+        REQUIRE( 0 == std::ranges::distance(counted(100, pulled) | coro::views::take(0)) );
+        REQUIRE( 0 == pulled );
+        REQUIRE( 5 == std::ranges::distance(counter(5) | coro::views::take(10)) );
+    }
+    // chunk() yields full chunks and a final partial one
+    {
+        std::vector<std::vector<unsigned>> chunks;
+        for(std::span<const unsigned> c : counter(7) | coro::views::chunk(3)) {
+            chunks.emplace_back(c.begin(), c.end());
+        }
+        REQUIRE( std::vector<std::vector<unsigned>>{ { 0, 1, 2 }, { 3, 4, 5 }, { 6 } } == chunks );
+        REQUIRE( 0 == std::ranges::distance(counter(0) | coro::views::chunk(3)) );
+        REQUIRE( 2 == std::ranges::distance(counter(6) | coro::views::chunk(3)) );
+
+        unsigned pulled = 0;
+        auto pipeline = counted(100, pulled) | coro::views::chunk(4);
+        auto it = pipeline.begin();
+        REQUIRE( 4 == (*it).size() );
+        REQUIRE( 4 == pulled );
+    }
+    // lvalue ranges are referenced
+    {
+        const std::vector<unsigned> src{ 1, 2, 3, 4, 5, 6 };
+        std::vector<unsigned> v;
+        for(std::span<const unsigned> c : src | coro::views::filter(is_even) | coro::views::chunk(2)) {
+            v.push_back(std::accumulate(c.begin(), c.end(), 0u));
+        }
+        REQUIRE( std::vector<unsigned>{ 6, 6 } == v );
+    }
+}
@@ -0,0 +1,354 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking coroutine frame allocation
+//============================================================================
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_frame_pool.hpp"
+#include "cpp_basics/coro_generator.hpp"
+#include "cpp_basics/coro_views.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of coro::Generator create/destroy cost
+ * using the global allocation functions (heap_frame), the thread-local FramePool (pooled_frame)
+ * and a caller-provided FrameArena.
+ *
+ * Further, nested generators walking a tree in-order, yielding each subtree via `co_yield elements_of(..)`
+ * compared to manually re-yielding each subtree's elements.
+ *
+ * Further, a 4-stage filter, transform, take and chunk pipeline over a generated stream
+ * fused via coro::views compared to materializing each stage into a vector.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> <operation> <n>` and creates `n` generators or yields `n` keys,
+ * see cpp_basics::BenchCSVListener.
+ *
+ * Operations
+ * - `create`: create and destroy one generator at a time, consuming its single value
+ * - `batch`: keep `batch_size` generators alive at once, mimicking many short-lived concurrent frames
+ * - `balanced` and `chain`: in-order walk of a balanced tree and of a chain of depth `n`, yielding `n` keys
+ * - `pipeline`: streams `n` generated values through the 4 stages
+ */
+namespace bench_env {
+    constexpr static const size_t batch_size = 256;
+
+    template<typename FrameAlloc>
+    coro::Generator<uint64_t, FrameAlloc> single(uint64_t v) {
+        co_yield v;
+    }
+
+    template<typename FrameAlloc>
+    uint64_t create(size_t n) {
+        uint64_t sum = 0;
+        for(size_t i = 0; i < n; ++i) {
+            auto gen = single<FrameAlloc>(i);
+            sum += gen();
+        }
+        return sum;
+    }
+
+    template<typename FrameAlloc>
+    uint64_t batch(size_t n) {
+        std::vector<coro::Generator<uint64_t, FrameAlloc>> gens;
+        gens.reserve(batch_size);
+        uint64_t sum = 0;
+        for(size_t i = 0; i < n; i += batch_size) {
+            for(size_t j = i; j < std::min(n, i + batch_size); ++j) {
+                gens.push_back(single<FrameAlloc>(j));
+            }
+            for(auto& gen : gens) {
+                sum += gen();
+            }
+            gens.clear();
+        }
+        return sum;
+    }
+
+    /** Binary tree node, `-1` denotes no child. */
+    struct node_t {
+        uint64_t key;
+        int32_t left;
+        int32_t right;
+    };
+    typedef std::vector<node_t> tree_t;
+
+    /** Balanced binary search tree of keys `[lo..hi)`, returns the root index. */
+    int32_t make_balanced(tree_t& tree, uint64_t lo, uint64_t hi) {
+        if( lo >= hi ) {
+            return -1;
+        }
+        const uint64_t mid = lo + ( hi - lo ) / 2;
+        const int32_t idx = int32_t(tree.size());
+        tree.push_back(node_t{mid, -1, -1});
+        const int32_t l = make_balanced(tree, lo, mid);
+        const int32_t r = make_balanced(tree, mid + 1, hi);
+        tree[idx].left = l;
+        tree[idx].right = r;
+        return idx;
+    }
+
+    /** Degenerated tree, i.e. a right-leaning chain of depth `n`, returns the root index. */
+    int32_t make_chain(tree_t& tree, uint64_t n) {
+        for(uint64_t i = 0; i < n; ++i) {
+            tree.push_back(node_t{i, -1, i + 1 < n ? int32_t(i + 1) : -1});
+        }
+        return 0 < n ? 0 : -1;
+    }
+
+    /** In-order walk, yielding the subtrees via elements_of(), i.e. one resume per key. */
+    coro::Generator<uint64_t> walk_nested(const tree_t& tree, int32_t idx) {
+        const node_t& n = tree[idx];
+        if( 0 <= n.left ) {
+            co_yield coro::elements_of(walk_nested(tree, n.left));
+        }
+        co_yield n.key;
+        if( 0 <= n.right ) {
+            co_yield coro::elements_of(walk_nested(tree, n.right));
+        }
+    }
+
+    /** In-order walk, manually re-yielding the subtrees, i.e. one resume per key and level. */
+    coro::Generator<uint64_t> walk_manual(const tree_t& tree, int32_t idx) {
+        const node_t& n = tree[idx];
+        if( 0 <= n.left ) {
+            for(auto gen = walk_manual(tree, n.left); gen; ) {
+                co_yield gen();
+            }
+        }
+        co_yield n.key;
+        if( 0 <= n.right ) {
+            for(auto gen = walk_manual(tree, n.right); gen; ) {
+                co_yield gen();
+            }
+        }
+    }
+
+    /** Recursive in-order walk w/o coroutines, baseline. */
+    void walk_recursive(const tree_t& tree, int32_t idx, uint64_t& sum) {
+        const node_t& n = tree[idx];
+        if( 0 <= n.left ) {
+            walk_recursive(tree, n.left, sum);
+        }
+        sum += n.key;
+        if( 0 <= n.right ) {
+            walk_recursive(tree, n.right, sum);
+        }
+    }
+
+    template<typename G>
+    uint64_t sum(G&& gen) {
+        uint64_t s = 0;
+        while( gen ) {
+            s += gen();
+        }
+        return s;
+    }
+
+    std::vector<size_t> tree_sizes() {
+        if( catch_perf_analysis ) {
+            return { 10'000, 1'000'000 };
+        } else {
+            return { 1'000 };
+        }
+    }
+
+    /** Manual nesting is quadratic for a chain, hence limited */
+    std::vector<size_t> chain_depths() {
+        if( catch_perf_analysis ) {
+            return { 100, 1'000, 3'000 };
+        } else {
+            return { 100 };
+        }
+    }
+
+    /** Pseudo random stream via xorshift64 */
+    coro::Generator<uint64_t> numbers(size_t n) {
+        uint64_t x = 0x9E3779B97F4A7C15ULL;
+        for(size_t i = 0; i < n; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            co_yield x;
+        }
+    }
+
+    constexpr static const size_t chunk_size = 64;
+
+    inline bool stage_filter(uint64_t v) noexcept { return 0 != ( v & 1 ); }
+    inline uint64_t stage_transform(uint64_t v) noexcept { return ( v >> 3 ) * 5; }
+
+    inline uint64_t reduce_chunk(std::span<const uint64_t> c) noexcept {
+        uint64_t m = 0;
+        for(uint64_t v : c) { m = std::max(m, v); }
+        return m ^ c.size();
+    }
+
+    /** Fused pipeline via coro::views, pulling each value through all stages */
+    uint64_t pipeline_views(size_t n) {
+        uint64_t res = 0;
+        for(std::span<const uint64_t> c : numbers(n) | coro::views::filter(stage_filter)
+                                                     | coro::views::transform(stage_transform)
+                                                     | coro::views::take(n / 4)
+                                                     | coro::views::chunk(chunk_size)) {
+            res += reduce_chunk(c);
+        }
+        return res;
+    }
+
+    /** Fused pipeline via std::views and coro::views::chunk() */
+    uint64_t pipeline_std_views(size_t n) {
+        uint64_t res = 0;
+        for(std::span<const uint64_t> c : numbers(n) | std::views::filter(stage_filter)
+                                                     | std::views::transform(stage_transform)
+                                                     | std::views::take(n / 4)
+                                                     | coro::views::chunk(chunk_size)) {
+            res += reduce_chunk(c);
+        }
+        return res;
+    }
+
+    /** Each stage materialized into a vector */
+    uint64_t pipeline_vectors(size_t n) {
+        std::vector<uint64_t> src;
+        for(uint64_t v : numbers(n)) { src.push_back(v); }
+        std::vector<uint64_t> filtered;
+        for(uint64_t v : src) {
+            if( stage_filter(v) ) { filtered.push_back(v); }
+        }
+        std::vector<uint64_t> transformed;
+        for(uint64_t v : filtered) { transformed.push_back(stage_transform(v)); }
+        std::vector<uint64_t> taken(transformed.begin(), transformed.begin() + std::min(n / 4, transformed.size()));
+        std::vector<std::vector<uint64_t>> chunks;
+        for(size_t i = 0; i < taken.size(); i += chunk_size) {
+            chunks.emplace_back(taken.begin() + i, taken.begin() + std::min(taken.size(), i + chunk_size));
+        }
+        uint64_t res = 0;
+        for(const std::vector<uint64_t>& c : chunks) { res += reduce_chunk(c); }
+        return res;
+    }
+
+    std::vector<size_t> pipeline_sizes() {
+        if( catch_perf_analysis ) {
+            return { 100'000, 1'000'000, 10'000'000 };
+        } else {
+            return { 10'000 };
+        }
+    }
+
+    std::vector<size_t> sizes() {
+        if( catch_perf_analysis ) {
+            return { 100'000, 1'000'000, 10'000'000 };
+        } else {
+            return { 1'000, 10'000 };
+        }
+    }
+}
+
+TEST_CASE( "Coroutine Frame Pool Benchmark 01", "[coroutine][generator][pool][benchmark]" ) {
+    using namespace bench_env;
+    coro::FramePool& pool = coro::FramePool::local();
+    alignas(std::max_align_t) static std::byte arena_buffer[batch_size * coro::FramePool::max_frame_size];
+
+    for(size_t n : sizes()) {
+        const std::string sn = std::to_string(n);
+        const uint64_t expected = uint64_t(n) * (n - 1) / 2;
+        REQUIRE( expected == create<coro::heap_frame>(n) );
+        REQUIRE( expected == create<coro::pooled_frame>(n) );
+        REQUIRE( expected == batch<coro::pooled_frame>(n) );
+
+        BENCHMARK("heap create "+sn) {
+            return create<coro::heap_frame>(n);
+        };
+        BENCHMARK("pool create "+sn) {
+            return create<coro::pooled_frame>(n);
+        };
+        BENCHMARK("arena create "+sn) {
+            coro::FrameArena arena(arena_buffer, sizeof(arena_buffer));
+            return create<coro::pooled_frame>(n);
+        };
+        BENCHMARK("heap batch "+sn) {
+            return batch<coro::heap_frame>(n);
+        };
+        BENCHMARK("pool batch "+sn) {
+            return batch<coro::pooled_frame>(n);
+        };
+        BENCHMARK("arena batch "+sn) {
+            coro::FrameArena arena(arena_buffer, sizeof(arena_buffer));
+            return batch<coro::pooled_frame>(n);
+        };
+    }
+
+    const coro::frame_pool_stats& stats = pool.stats();
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "frame pool: hits %zu, misses %zu, peak %td, cached %zu\n",
+                  stats.hits, stats.misses, stats.peak, pool.cached());
+    WARN(buf);
+    REQUIRE( 0 == stats.live );
+    REQUIRE( stats.misses < stats.hits );
+}
+
+TEST_CASE( "Coroutine Generator Nested Benchmark 01", "[coroutine][generator][nested][benchmark]" ) {
+    using namespace bench_env;
+
+    auto run = [](const std::string& shape, const tree_t& tree, int32_t root) {
+        const std::string sn = std::to_string(tree.size());
+        uint64_t expected = 0;
+        walk_recursive(tree, root, expected);
+        REQUIRE( expected == sum(walk_nested(tree, root)) );
+        REQUIRE( expected == sum(walk_manual(tree, root)) );
+
+        BENCHMARK("recursive "+shape+" "+sn) {
+            uint64_t s = 0;
+            walk_recursive(tree, root, s);
+            return s;
+        };
+        BENCHMARK("elements_of "+shape+" "+sn) {
+            return sum(walk_nested(tree, root));
+        };
+        BENCHMARK("manual "+shape+" "+sn) {
+            return sum(walk_manual(tree, root));
+        };
+    };
+    for(size_t n : tree_sizes()) {
+        tree_t tree;
+        const int32_t root = make_balanced(tree, 0, n);
+        run("balanced", tree, root);
+    }
+    for(size_t n : chain_depths()) {
+        tree_t tree;
+        const int32_t root = make_chain(tree, n);
+        run("chain", tree, root);
+    }
+}
+
+TEST_CASE( "Coroutine Generator Pipeline Benchmark 01", "[coroutine][generator][range][benchmark]" ) {
+    using namespace bench_env;
+
+    for(size_t n : pipeline_sizes()) {
+        const std::string sn = std::to_string(n);
+        const uint64_t expected = pipeline_vectors(n);
+        REQUIRE( expected == pipeline_views(n) );
+        REQUIRE( expected == pipeline_std_views(n) );
+
+        BENCHMARK("coro_views pipeline "+sn) {
+            return pipeline_views(n);
+        };
+        BENCHMARK("std_views pipeline "+sn) {
+            return pipeline_std_views(n);
+        };
+        BENCHMARK("vectors pipeline "+sn) {
+            return pipeline_vectors(n);
+        };
+    }
+}
@@ -0,0 +1,195 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine epoll reactor with async I/O
+//============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_reactor.hpp"
+
+/**
+ * Lesson 5.1 Coroutine I/O on a single-threaded coro::EpollReactor,
+ * suspending on `EAGAIN` and resumed by the reactor on readiness.
+ */
+namespace test_env {
+    std::vector<std::byte> pattern(size_t size, uint8_t seed) {
+        std::vector<std::byte> data(size);
+        for(size_t i = 0; i < size; ++i) {
+            data[i] = std::byte( uint8_t( seed + i * 31 ) );
+        }
+        return data;
+    }
+
+    coro::Task<void> write_all(coro::AsyncFd& fd, std::span<const std::byte> data) {
+        co_await fd.write(data);
+        fd.close();
+    }
+
+    coro::Task<void> read_all(coro::AsyncFd& fd, std::vector<std::byte>& out) {
+        std::byte buf[4096];
+        size_t n;
+        while( 0 < ( n = co_await fd.read_some(buf) ) ) {
+            out.insert(out.end(), buf, buf + n);
+        }
+    }
+
+    /** Echoes all received bytes until the end of stream, then closes. */
+    coro::Task<void> echo(coro::AsyncFd& fd) {
+        std::byte buf[512];
+        size_t n;
+        while( 0 < ( n = co_await fd.read_some(buf) ) ) {
+            co_await fd.write(std::span<const std::byte>(buf, n));
+        }
+        fd.close();
+    }
+
+    /** Sends the message, half-closes and reads the echo until the end of stream. */
+    coro::Task<void> request(coro::AsyncFd& fd, std::span<const std::byte> msg, std::vector<std::byte>& reply) {
+        co_await fd.write(msg);
+        ::shutdown(fd.native_handle(), SHUT_WR);
+        co_await read_all(fd, reply);
+    }
+
+    /** Resumes the awaiting coroutine on the reactor from another thread. */
+    struct other_thread_post {
+        coro::EpollReactor& reactor;
+
+        constexpr bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            std::thread([r = &reactor, h]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                r->post(h);
+            }).detach();
+        }
+        constexpr void await_resume() const noexcept { }
+    };
+
+    coro::Task<void> hop(coro::EpollReactor& reactor, std::thread::id& resumed_on) {
+        co_await other_thread_post{reactor};
+        resumed_on = std::this_thread::get_id();
+    }
+
+    size_t fd_limit() {
+        rlimit rl{};
+        ::getrlimit(RLIMIT_NOFILE, &rl);
+        return rl.rlim_cur;
+    }
+}
+
+TEST_CASE( "Coroutine Reactor Test 01", "[coroutine][reactor][pipe]" ) {
+    using namespace test_env;
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // 1 MiB through a pipe of 64 KiB capacity, the writer suspends on a full pipe
+    {
+        coro::EpollReactor reactor;
+        int p[2];
+        REQUIRE( 0 == ::pipe(p) );
+        coro::AsyncFd rd(reactor, p[0]), wr(reactor, p[1]);
+        REQUIRE( true == rd.pollable() );
+
+        const std::vector<std::byte> data = pattern(1 << 20, 7);
+        std::vector<std::byte> received;
+        reactor.spawn(read_all(rd, received));
+        reactor.spawn(write_all(wr, data));
+        REQUIRE( 2 == reactor.active() );
+        reactor.run();
+        REQUIRE( 0 == reactor.active() );
+        REQUIRE( data == received );
+    }
+    // writing to a pipe w/o reader fails with EPIPE, rethrown by run()
+    {
+        coro::EpollReactor reactor;
+        int p[2];
+        REQUIRE( 0 == ::pipe(p) );
+        coro::AsyncFd rd(reactor, p[0]), wr(reactor, p[1]);
+        rd.close();
+        const std::vector<std::byte> data = pattern(16, 0);
+        reactor.spawn(write_all(wr, data));
+        REQUIRE_THROWS_AS( reactor.run(), std::system_error );
+    }
+    // resumption posted from another thread wakes up the reactor
+    {
+        coro::EpollReactor reactor;
+        std::thread::id resumed_on;
+        reactor.spawn(hop(reactor, resumed_on));
+        reactor.run();
+        REQUIRE( std::this_thread::get_id() == resumed_on );
+    }
+}
+
+TEST_CASE( "Coroutine Reactor Test 02", "[coroutine][reactor][socket]" ) {
+    using namespace test_env;
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // one thread serves all socketpair streams concurrently
+    const size_t streams = std::min<size_t>(1000, ( fd_limit() - 64 ) / 2);
+    coro::EpollReactor reactor;
+    std::vector<std::unique_ptr<coro::AsyncFd>> servers, clients;
+    std::vector<std::vector<std::byte>> messages(streams), replies(streams);
+    for(size_t i = 0; i < streams; ++i) {
+        int sv[2];
+        REQUIRE( 0 == ::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) );
+        servers.push_back(std::make_unique<coro::AsyncFd>(reactor, sv[0]));
+        clients.push_back(std::make_unique<coro::AsyncFd>(reactor, sv[1]));
+        messages[i] = pattern(1000 + 97 * ( i % 300 ), uint8_t(i));
+    }
+    for(size_t i = 0; i < streams; ++i) {
+        reactor.spawn(echo(*servers[i]));
+        reactor.spawn(request(*clients[i], messages[i], replies[i]));
+    }
+    reactor.run();
+    size_t ok = 0;
+    for(size_t i = 0; i < streams; ++i) {
+        ok += messages[i] == replies[i] ? 1 : 0;
+    }
+    WARN("echo streams " << streams << ", ok " << ok);
+    REQUIRE( streams == ok );
+}
+
+TEST_CASE( "Coroutine Reactor Test 03", "[coroutine][reactor][file]" ) {
+    using namespace test_env;
+
+    // regular files aren't pollable, their I/O completes w/o suspension
+    char path[] = "/tmp/cpp_basics_reactor_XXXXXX";
+    const int fd = ::mkstemp(path);
+    REQUIRE( 0 <= fd );
+    ::unlink(path);
+
+    coro::EpollReactor reactor;
+    coro::AsyncFd file(reactor, fd);
+    REQUIRE( false == file.pollable() );
+
+    const std::vector<std::byte> data = pattern(100'000, 3);
+    std::vector<std::byte> received(data.size() + 10);
+    size_t n = 0;
+    auto io = [](coro::AsyncFd& f, std::span<const std::byte> in, std::span<std::byte> out, size_t& count) -> coro::Task<void> {
+        co_await f.write(in);
+        ::lseek(f.native_handle(), 0, SEEK_SET);
+        count = co_await f.read(out); // short read at end of file
+    };
+    reactor.spawn(io(file, data, received, n));
+    reactor.run();
+    REQUIRE( data.size() == n );
+    received.resize(n);
+    REQUIRE( data == received );
+}
@@ -0,0 +1,158 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine bounded MPMC channel
+//============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_channel.hpp"
+
+/**
+ * Lesson 5.1 Coroutine producers and consumers talking through a bounded coro::Channel,
+ * suspending on a full or empty channel instead of blocking their thread.
+ */
+namespace test_env {
+    coro::Task<void> producer(coro::Channel<uint64_t>& ch, uint64_t first, size_t n) {
+        for(size_t i = 0; i < n; ++i) {
+            if( !co_await ch.send(first + i) ) {
+                throw std::runtime_error("channel closed");
+            }
+        }
+    }
+
+    struct consumed {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+    };
+
+    coro::Task<consumed> consumer(coro::Channel<uint64_t>& ch) {
+        consumed res;
+        while( std::optional<uint64_t> v = co_await ch.recv() ) {
+            ++res.count;
+            res.sum += *v;
+        }
+        co_return res;
+    }
+
+    /** Awaits all producers, then closes the channel to end the consumers. */
+    coro::Task<void> close_after(coro::Channel<uint64_t>& ch, std::vector<coro::JoinHandle<void>>& producers) {
+        for(coro::JoinHandle<void>& h : producers) {
+            co_await h;
+        }
+        ch.close();
+    }
+}
+
+TEST_CASE( "Coroutine Channel Test 01", "[coroutine][channel]" ) {
+    using namespace test_env;
+
+    // non-suspending operations, capacity rounded up to a power of two
+    {
+        coro::Channel<std::unique_ptr<int>> ch(3);
+        REQUIRE( 4 == ch.capacity() );
+        for(int i = 0; i < 4; ++i) {
+            std::unique_ptr<int> v = std::make_unique<int>(i);
+            REQUIRE( true == ch.try_send(v) );
+            REQUIRE( nullptr == v );
+        }
+        std::unique_ptr<int> v = std::make_unique<int>(4);
+        REQUIRE( false == ch.try_send(v) ); // full
+        REQUIRE( nullptr != v );
+        REQUIRE( 4 == ch.size() );
+        REQUIRE( 0 == **ch.try_recv() );
+        REQUIRE( 1 == **ch.try_recv() );
+        // remaining values are destroyed by the channel
+    }
+    // closing lets the buffered values be received, then ends receivers and fails senders
+    {
+        coro::Channel<uint64_t> ch(4);
+        auto fill = [](coro::Channel<uint64_t>& c) -> coro::Task<bool> {
+            co_await c.send(1);
+            co_await c.send(2);
+            c.close();
+            co_return co_await c.send(3);
+        };
+        REQUIRE( false == coro::sync_wait(fill(ch)) );
+        const consumed r = coro::sync_wait(consumer(ch));
+        REQUIRE( 2 == r.count );
+        REQUIRE( 3 == r.sum );
+    }
+}
+
+TEST_CASE( "Coroutine Channel Test 02", "[coroutine][channel][backpressure]" ) {
+    using namespace test_env;
+
+    // producer suspends on the full channel w/o blocking its single worker thread
+    {
+        coro::WorkStealingScheduler sched(1);
+        coro::Channel<uint64_t> ch(2);
+        auto p = sched.spawn(producer(ch, 0, 10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE( false == p.done() );
+        REQUIRE( 2 == ch.size() );
+
+        // the same worker is free to run the consumer, resuming the producer inline
+        auto c = sched.spawn(consumer(ch));
+        p.join();
+        ch.close();
+        const consumed r = c.join();
+        REQUIRE( 10 == r.count );
+        REQUIRE( 45 == r.sum );
+    }
+    // consumer suspends on the empty channel
+    {
+        coro::WorkStealingScheduler sched(2);
+        coro::Channel<uint64_t> ch(2, &sched);
+        auto c = sched.spawn(consumer(ch));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE( false == c.done() );
+        sched.spawn(producer(ch, 1, 100)).join();
+        ch.close();
+        const consumed r = c.join();
+        REQUIRE( 100 == r.count );
+        REQUIRE( 5050 == r.sum );
+    }
+}
+
+TEST_CASE( "Coroutine Channel Test 03", "[coroutine][channel][mpmc]" ) {
+    using namespace test_env;
+    const size_t producers = 4, consumers = 4;
+    const size_t per_producer = 20'000;
+
+    for(bool post : { false, true }) {
+        coro::WorkStealingScheduler sched(4);
+        coro::Channel<uint64_t> ch(16, post ? &sched : nullptr);
+        std::vector<coro::JoinHandle<consumed>> cs;
+        for(size_t i = 0; i < consumers; ++i) {
+            cs.push_back(sched.spawn(consumer(ch)));
+        }
+        std::vector<coro::JoinHandle<void>> ps;
+        for(size_t i = 0; i < producers; ++i) {
+            ps.push_back(sched.spawn(producer(ch, i * per_producer, per_producer)));
+        }
+        sched.spawn(close_after(ch, ps)).join();
+
+        consumed total;
+        for(coro::JoinHandle<consumed>& h : cs) {
+            const consumed r = h.join();
+            total.count += r.count;
+            total.sum += r.sum;
+        }
+        const uint64_t n = producers * per_producer;
+        REQUIRE( n == total.count );
+        REQUIRE( n * (n - 1) / 2 == total.sum ); // each value received exactly once
+    }
+}
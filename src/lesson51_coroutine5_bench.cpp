@@ -0,0 +1,143 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking the coroutine bounded MPMC channel
+//============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_channel.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of coro::Channel message throughput.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> ... <n>` and passes `n` messages,
+ * i.e. the bench-csv ns_per_element column reports ns per message, see cpp_basics::BenchCSVListener.
+ * A final messages/sec summary is emitted via WARN.
+ *
+ * Variants
+ * - `ping_pong <resume>`: one round trip per message through two channels of capacity 2,
+ *   i.e. every send and receive suspends and wakes the peer, measuring the hand-off latency.
+ *   `inline` resumes the woken peer on the waker's thread, `posted` via the scheduler.
+ * - `fan_in producers <p>`: `p` producers send `n / p` messages each into one channel of capacity 64,
+ *   drained by one consumer, measuring throughput under producer contention.
+ */
+namespace bench_env {
+    typedef coro::Channel<uint64_t> channel_t;
+
+    coro::Task<uint64_t> ping(channel_t& out, channel_t& in, size_t n) {
+        uint64_t sum = 0;
+        for(size_t i = 0; i < n; ++i) {
+            co_await out.send(i);
+            sum += *co_await in.recv();
+        }
+        out.close();
+        co_return sum;
+    }
+
+    coro::Task<void> pong(channel_t& in, channel_t& out) {
+        while( std::optional<uint64_t> v = co_await in.recv() ) {
+            co_await out.send(*v);
+        }
+    }
+
+    uint64_t ping_pong(coro::WorkStealingScheduler& sched, bool posted, size_t n) {
+        channel_t a(2, posted ? &sched : nullptr), b(2, posted ? &sched : nullptr);
+        auto p = sched.spawn(pong(a, b));
+        const uint64_t sum = sched.spawn(ping(a, b, n)).join();
+        p.join();
+        return sum;
+    }
+
+    coro::Task<void> produce(channel_t& ch, size_t n) {
+        for(size_t i = 0; i < n; ++i) {
+            co_await ch.send(i);
+        }
+    }
+
+    coro::Task<uint64_t> drain(channel_t& ch, size_t n) {
+        uint64_t sum = 0;
+        for(size_t i = 0; i < n; ++i) {
+            sum += *co_await ch.recv();
+        }
+        co_return sum;
+    }
+
+    uint64_t fan_in(coro::WorkStealingScheduler& sched, size_t producers, size_t n) {
+        channel_t ch(64, &sched);
+        const size_t per = n / producers;
+        auto c = sched.spawn(drain(ch, per * producers));
+        std::vector<coro::JoinHandle<void>> ps;
+        for(size_t i = 0; i < producers; ++i) {
+            ps.push_back(sched.spawn(produce(ch, per)));
+        }
+        for(coro::JoinHandle<void>& h : ps) {
+            h.join();
+        }
+        return c.join();
+    }
+
+    size_t thread_count() {
+        return std::max<size_t>(2, std::thread::hardware_concurrency());
+    }
+
+    size_t message_count() {
+        return catch_perf_analysis ? 1'000'000 : 10'000;
+    }
+}
+
+TEST_CASE( "Coroutine Channel Benchmark 01", "[coroutine][channel][benchmark]" ) {
+    using namespace bench_env;
+    const size_t n = message_count();
+    const std::string sn = std::to_string(n);
+    const std::vector<size_t> producer_counts = { 1, 2, 4, 8 };
+    coro::WorkStealingScheduler sched(thread_count());
+
+    BENCHMARK("ping_pong inline "+sn) {
+        return ping_pong(sched, false, n);
+    };
+    BENCHMARK("ping_pong posted "+sn) {
+        return ping_pong(sched, true, n);
+    };
+    for(size_t p : producer_counts) {
+        BENCHMARK("fan_in producers "+std::to_string(p)+" "+sn) {
+            return fan_in(sched, p, n);
+        };
+    }
+
+    // messages/sec summary of single timed runs
+    std::string summary = "messages/sec, "+sn+" messages, "+std::to_string(sched.size())+" threads\n";
+    auto timed = [&](const char* name, auto&& fn, uint64_t expected) {
+        auto t0 = std::chrono::steady_clock::now();
+        const uint64_t sum = fn();
+        auto t1 = std::chrono::steady_clock::now();
+        REQUIRE( expected == sum );
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "- %-20s %12.0f\n", name, double(n) / std::chrono::duration<double>(t1 - t0).count());
+        summary += buf;
+    };
+    const uint64_t sum_n = uint64_t(n) * (n - 1) / 2;
+    timed("ping_pong inline", [&]() { return ping_pong(sched, false, n); }, sum_n);
+    timed("ping_pong posted", [&]() { return ping_pong(sched, true, n); }, sum_n);
+    for(size_t p : producer_counts) {
+        const uint64_t per = n / p;
+        const std::string name = "fan_in producers "+std::to_string(p);
+        timed(name.c_str(), [&]() { return fan_in(sched, p, n); }, p * per * (per - 1) / 2);
+    }
+    WARN(summary);
+}
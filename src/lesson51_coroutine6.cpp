@@ -0,0 +1,218 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine timers and deadline-based cancellation
+//============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_timer.hpp"
+
+using namespace std::chrono_literals;
+
+/**
+ * Lesson 5.1 Coroutine timers on a coro::TimingWheel driven by coro::TimerService,
+ * cancelling awaiting chains of tasks via deadlines.
+ */
+namespace test_env {
+    typedef coro::TimerService::clock_type clock_type;
+
+    struct fired_node : coro::timer_node {
+        uint64_t fired_at = 0;
+    };
+
+    /** Counts live coroutine frames */
+    struct frame_guard {
+        static inline std::atomic<int> live = 0;
+        frame_guard() { live.fetch_add(1); }
+        ~frame_guard() { live.fetch_sub(1); }
+    };
+
+    coro::Task<int> sleeper(coro::TimerService& timers, clock_type::duration d, int v) {
+        frame_guard g;
+        co_await timers.sleep_for(d);
+        co_return v;
+    }
+
+    /** Awaits a chain of `depth` tasks, the innermost sleeping */
+    coro::Task<int> chain(coro::TimerService& timers, size_t depth, clock_type::duration d) {
+        frame_guard g;
+        if( 0 == depth ) {
+            co_return co_await sleeper(timers, d, 0);
+        }
+        co_return 1 + co_await chain(timers, depth - 1, d);
+    }
+
+    coro::Task<double> elapsed_ms(coro::TimerService& timers, clock_type::duration d) {
+        const clock_type::time_point t0 = clock_type::now();
+        co_await timers.sleep_for(d);
+        co_return std::chrono::duration<double, std::milli>(clock_type::now() - t0).count();
+    }
+}
+
+TEST_CASE( "Coroutine Timer Test 01", "[coroutine][timer][wheel]" ) {
+    using namespace test_env;
+
+    // each timer expires exactly at its tick across all levels and beyond the covered range
+    coro::TimingWheel wheel(1000);
+    std::mt19937_64 rng(42);
+    std::vector<fired_node> nodes(20'000);
+    const uint64_t range = uint64_t(1) << 25; // beyond 64^4 ticks
+    for(fired_node& n : nodes) {
+        const uint64_t d = 0 == rng() % 4 ? rng() % 100 : rng() % range;
+        wheel.add(n, wheel.now() + 1 + d);
+    }
+    REQUIRE( nodes.size() == wheel.size() );
+
+    // cancel every 10th
+    for(size_t i = 0; i < nodes.size(); i += 10) {
+        wheel.remove(nodes[i]);
+    }
+    const size_t armed = wheel.size();
+
+    size_t fired = 0;
+    bool exact = true;
+    const uint64_t end = wheel.now() + range + 2;
+    while( wheel.now() < end ) {
+        // irregular steps, as the timer thread may be late
+        wheel.advance(wheel.now() + 1 + rng() % 3, [&](coro::timer_node& tn) {
+            fired_node& n = static_cast<fired_node&>(tn);
+            ++fired;
+            exact = exact && n.expiry == wheel.now();
+            n.fired_at = wheel.now();
+        });
+    }
+    REQUIRE( true == exact );
+    REQUIRE( armed == fired );
+    REQUIRE( true == wheel.empty() );
+    bool cancelled_only = true;
+    for(size_t i = 0; i < nodes.size(); ++i) {
+        cancelled_only = cancelled_only && ( 0 == i % 10 ) == ( 0 == nodes[i].fired_at );
+    }
+    REQUIRE( true == cancelled_only );
+
+    // a single far timer, e.g. one hour at 1ms ticks, is reached by a few jumps to each cascade instead of one step per tick
+    {
+        coro::TimingWheel w(1000);
+        REQUIRE( std::numeric_limits<uint64_t>::max() == w.next_expiry() );
+        fired_node n;
+        const uint64_t expiry = w.now() + 3'600'000;
+        w.add(n, expiry);
+        size_t steps = 0;
+        uint64_t prev = w.now();
+        while( !w.empty() ) {
+            const uint64_t next = w.next_expiry();
+            REQUIRE( prev < next );
+            REQUIRE( next <= expiry );
+            w.advance(next, [&](coro::timer_node& tn) { static_cast<fired_node&>(tn).fired_at = w.now(); });
+            prev = next;
+            ++steps;
+        }
+        REQUIRE( expiry == n.fired_at );
+        REQUIRE( steps <= coro::TimingWheel::levels );
+
+        // an earlier timer added in between is reported next
+        fired_node a, b;
+        w.add(a, w.now() + 5000);
+        REQUIRE( w.next_expiry() <= w.now() + 5000 );
+        w.add(b, w.now() + 3);
+        REQUIRE( w.now() + 3 == w.next_expiry() );
+        w.remove(b);
+        w.remove(a);
+        REQUIRE( std::numeric_limits<uint64_t>::max() == w.next_expiry() );
+    }
+}
+
+TEST_CASE( "Coroutine Timer Test 02", "[coroutine][timer][sleep]" ) {
+    using namespace test_env;
+
+    // resumed on the timer thread, never early
+    {
+        coro::TimerService timers;
+        REQUIRE( 5.0 <= coro::sync_wait(elapsed_ms(timers, 5ms)) );
+        REQUIRE( 7 == coro::sync_wait(sleeper(timers, 0ms, 7)) );
+    }
+    // many concurrent sleepers resumed on the scheduler
+    {
+        coro::WorkStealingScheduler sched(2);
+        coro::TimerService timers(&sched);
+        std::vector<coro::JoinHandle<int>> hs;
+        for(int i = 0; i < 1000; ++i) {
+            hs.push_back(sched.spawn(sleeper(timers, std::chrono::milliseconds(1 + i % 20), i)));
+        }
+        int64_t sum = 0;
+        for(coro::JoinHandle<int>& h : hs) {
+            sum += h.join();
+        }
+        REQUIRE( 999 * 1000 / 2 == sum );
+        REQUIRE( 0 == timers.size() );
+    }
+    // destroying a suspended frame disarms its timer
+    {
+        coro::TimerService timers;
+        {
+            coro::Task<int> t = sleeper(timers, 10s, 0);
+            t.handle().resume();
+            REQUIRE( 1 == timers.size() );
+            REQUIRE( 1 == frame_guard::live.load() );
+        }
+        REQUIRE( 0 == timers.size() );
+        REQUIRE( 0 == frame_guard::live.load() );
+    }
+}
+
+TEST_CASE( "Coroutine Timer Test 03", "[coroutine][timer][deadline]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(2);
+    coro::TimerService timers(&sched);
+
+    // completes within its deadline
+    REQUIRE( 3 == coro::sync_wait(timers.with_deadline(sleeper(timers, 5ms, 3), 10s)) );
+
+    // cancellation propagates down the awaiting chain, unwinding and destroying all frames
+    {
+        const clock_type::time_point t0 = clock_type::now();
+        REQUIRE_THROWS_AS( coro::sync_wait(timers.with_deadline(chain(timers, 100, 10s), 20ms)), coro::deadline_exceeded );
+        REQUIRE( clock_type::now() - t0 < 5s );
+        REQUIRE( 0 == frame_guard::live.load() );
+        REQUIRE( 0 == timers.size() );
+    }
+    // an outer deadline cancels an inner one's task, reported as the outer deadline
+    {
+        auto nested = [](coro::TimerService& ts) -> coro::Task<int> {
+            co_return co_await ts.with_deadline(chain(ts, 10, 10s), 10s);
+        };
+        REQUIRE_THROWS_AS( coro::sync_wait(timers.with_deadline(nested(timers), 20ms)), coro::deadline_exceeded );
+        REQUIRE( 0 == frame_guard::live.load() );
+    }
+    // cancelled w/o suspension once stop has been requested
+    {
+        auto busy = [](coro::TimerService& ts) -> coro::Task<int> {
+            std::this_thread::sleep_for(30ms); // not cancellable
+            co_await ts.sleep_for(0ms);        // ready, not suspending
+            co_await ts.sleep_for(1ms);        // cancelled
+            co_return 1;
+        };
+        REQUIRE_THROWS_AS( coro::sync_wait(timers.with_deadline(busy(timers), 10ms)), coro::deadline_exceeded );
+    }
+    // stop token of the awaiting task
+    {
+        auto check = [](coro::TimerService& ts) -> coro::Task<bool> {
+            co_await ts.sleep_for(0ms);
+            co_return (co_await coro::this_stop_token()).stop_possible();
+        };
+        REQUIRE( false == coro::sync_wait(check(timers)) );
+        REQUIRE( true == coro::sync_wait(timers.with_deadline(check(timers), 10s)) );
+    }
+}
@@ -0,0 +1,157 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking the coroutine timing wheel
+//============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_timer.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of coro::TimingWheel against ordered containers, and of a million concurrent coroutine timers.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<container> <operation> <n>` and handles `n` timers,
+ * i.e. the bench-csv ns_per_element column reports ns per timer, see cpp_basics::BenchCSVListener.
+ *
+ * Operations
+ * - `add_remove`: arms `n` timers at random expiries, then cancels all, O(1) each on the wheel vs O(log n) on a std::multimap
+ * - `expire`: arms `n` timers at random expiries, then advances until all expired, vs popping a std::priority_queue
+ *
+ * A final WARN summary reports `n` coroutines concurrently suspended in `sleep_for()` on a coro::TimerService,
+ * resumed on the scheduler, i.e. `n` concurrently armed timers.
+ */
+namespace bench_env {
+    constexpr uint64_t expiry_range = uint64_t(1) << 20;
+
+    std::vector<uint64_t> expiries(size_t n) {
+        std::mt19937_64 rng(n);
+        std::vector<uint64_t> res(n);
+        for(uint64_t& e : res) {
+            e = 1 + rng() % expiry_range;
+        }
+        return res;
+    }
+
+    uint64_t wheel_add_remove(std::vector<coro::timer_node>& nodes, const std::vector<uint64_t>& exp) {
+        coro::TimingWheel wheel;
+        for(size_t i = 0; i < nodes.size(); ++i) {
+            wheel.add(nodes[i], exp[i]);
+        }
+        const uint64_t size = wheel.size();
+        for(coro::timer_node& n : nodes) {
+            wheel.remove(n);
+        }
+        return size;
+    }
+
+    uint64_t multimap_add_remove(const std::vector<uint64_t>& exp) {
+        std::multimap<uint64_t, size_t> timers;
+        std::vector<std::multimap<uint64_t, size_t>::iterator> handles;
+        handles.reserve(exp.size());
+        for(size_t i = 0; i < exp.size(); ++i) {
+            handles.push_back(timers.emplace(exp[i], i));
+        }
+        const uint64_t size = timers.size();
+        for(auto it : handles) {
+            timers.erase(it);
+        }
+        return size;
+    }
+
+    uint64_t wheel_expire(std::vector<coro::timer_node>& nodes, const std::vector<uint64_t>& exp) {
+        coro::TimingWheel wheel;
+        for(size_t i = 0; i < nodes.size(); ++i) {
+            wheel.add(nodes[i], exp[i]);
+        }
+        uint64_t sum = 0;
+        wheel.advance(expiry_range, [&](coro::timer_node& n) { sum += n.expiry; });
+        return sum;
+    }
+
+    uint64_t priority_queue_expire(const std::vector<uint64_t>& exp) {
+        std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> timers;
+        for(uint64_t e : exp) {
+            timers.push(e);
+        }
+        uint64_t sum = 0;
+        while( !timers.empty() ) {
+            sum += timers.top();
+            timers.pop();
+        }
+        return sum;
+    }
+
+    coro::Task<void> sleeper(coro::TimerService& timers, std::chrono::milliseconds d) {
+        co_await timers.sleep_for(d);
+    }
+
+    size_t timer_count() {
+        return catch_perf_analysis ? 1'000'000 : 10'000;
+    }
+}
+
+TEST_CASE( "Coroutine Timer Benchmark 01", "[coroutine][timer][benchmark]" ) {
+    using namespace bench_env;
+    const size_t n = timer_count();
+    const std::string sn = std::to_string(n);
+    const std::vector<uint64_t> exp = expiries(n);
+    std::vector<coro::timer_node> nodes(n);
+
+    BENCHMARK("wheel add_remove "+sn) {
+        return wheel_add_remove(nodes, exp);
+    };
+    BENCHMARK("multimap add_remove "+sn) {
+        return multimap_add_remove(exp);
+    };
+    BENCHMARK("wheel expire "+sn) {
+        return wheel_expire(nodes, exp);
+    };
+    BENCHMARK("priority_queue expire "+sn) {
+        return priority_queue_expire(exp);
+    };
+    REQUIRE( wheel_expire(nodes, exp) == priority_queue_expire(exp) );
+
+    // n concurrent coroutine timers, expiring after all have been armed
+    {
+        const std::chrono::milliseconds base = catch_perf_analysis ? std::chrono::milliseconds(2000) : std::chrono::milliseconds(100);
+        typedef coro::TimerService::clock_type clock_type;
+        coro::WorkStealingScheduler sched(2);
+        coro::TimerService timers(&sched);
+        std::vector<coro::JoinHandle<void>> hs;
+        hs.reserve(n);
+        const clock_type::time_point t0 = clock_type::now();
+        for(size_t i = 0; i < n; ++i) {
+            hs.push_back(sched.spawn(sleeper(timers, base + std::chrono::milliseconds(i % 100))));
+        }
+        const clock_type::time_point t1 = clock_type::now();
+        const size_t armed = timers.size();
+        for(coro::JoinHandle<void>& h : hs) {
+            h.join();
+        }
+        const clock_type::time_point t2 = clock_type::now();
+        REQUIRE( 0 == timers.size() );
+
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "%zu concurrent sleep_for(%lld..%lld ms): spawn+arm %.1f ns/timer, %zu armed, all resumed after %.1f ms\n",
+                      n, (long long)base.count(), (long long)base.count() + 99, std::chrono::duration<double, std::nano>(t1 - t0).count() / double(n), armed,
+                      std::chrono::duration<double, std::milli>(t2 - t0).count());
+        WARN(buf);
+    }
+}
@@ -0,0 +1,266 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine async generator streaming records
+//============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <csignal>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_reactor.hpp"
+#include "cpp_basics/coro_timer.hpp"
+#include "cpp_basics/coro_async_generator.hpp"
+
+using namespace std::chrono_literals;
+
+/**
+ * Lesson 5.1 Coroutine generators awaiting in between their yields via coro::AsyncGenerator,
+ * parsing records of a stream as it arrives on a coro::EpollReactor,
+ * and prefetching the next element on a coro::WorkStealingScheduler.
+ */
+namespace test_env {
+    /** Counts live coroutine frames */
+    struct frame_guard {
+        static inline std::atomic<int> live = 0;
+        frame_guard() { live.fetch_add(1); }
+        ~frame_guard() { live.fetch_sub(1); }
+    };
+
+    coro::Task<int> identity(int v) {
+        co_return v;
+    }
+
+    /** Yields 0 .. n-1, each awaited from a task, then throws if requested. */
+    coro::AsyncGenerator<int> numbers(int n, bool fail = false) {
+        frame_guard g;
+        for(int i = 0; i < n; ++i) {
+            co_yield co_await identity(i);
+        }
+        if( fail ) {
+            throw std::runtime_error("numbers failed");
+        }
+    }
+
+    coro::Task<int64_t> sum_all(coro::AsyncGenerator<int> gen) {
+        int64_t sum = 0;
+        while( std::optional<int> v = co_await gen.next() ) {
+            sum += *v;
+        }
+        co_return sum;
+    }
+
+    /** Consumes only the first `n` elements, destroying the generator. */
+    coro::Task<int64_t> sum_first(coro::AsyncGenerator<int> gen, int n) {
+        int64_t sum = 0;
+        for(int i = 0; i < n; ++i) {
+            sum += *co_await gen.next();
+        }
+        co_return sum;
+    }
+
+    /** Counts elements consumed before the generator's exception. */
+    coro::Task<int> count_until_error(coro::AsyncGenerator<int> gen) {
+        int count = 0;
+        try {
+            while( co_await gen.next() ) {
+                ++count;
+            }
+        } catch (const std::runtime_error&) {
+            co_return -count;
+        }
+        co_return count;
+    }
+
+    coro::AsyncGenerator<bool> stop_possible() {
+        co_yield (co_await coro::this_stop_token()).stop_possible();
+    }
+
+    coro::AsyncGenerator<int> sleepy(coro::TimerService& timers) {
+        co_yield 1;
+        co_await timers.sleep_for(10s); // cancelled
+        co_yield 2;
+    }
+
+    template<typename T>
+    coro::Task<T> first(coro::AsyncGenerator<T> gen) {
+        T res{};
+        while( std::optional<T> v = co_await gen.next() ) {
+            res = *v;
+        }
+        co_return res;
+    }
+
+    std::string record(size_t i) {
+        return "record " + std::to_string(i) + std::string(i % 50, '.');
+    }
+
+    coro::Task<void> write_records(coro::AsyncFd& fd, size_t count) {
+        std::string buf;
+        for(size_t i = 0; i < count; ++i) {
+            buf += record(i);
+            buf += '\n';
+            if( 8192 <= buf.size() || i + 1 == count ) {
+                co_await fd.write(std::as_bytes(std::span<const char>(buf)));
+                buf.clear();
+            }
+        }
+        fd.close();
+    }
+
+    /** Yields each newline terminated record as read, w/o buffering the stream. */
+    coro::AsyncGenerator<std::string> records(coro::AsyncFd& fd) {
+        char buf[4096];
+        std::string line;
+        size_t n;
+        while( 0 < ( n = co_await fd.read_some(std::as_writable_bytes(std::span<char>(buf))) ) ) {
+            for(size_t i = 0; i < n; ++i) {
+                if( '\n' == buf[i] ) {
+                    co_yield std::move(line);
+                    line.clear();
+                } else {
+                    line += buf[i];
+                }
+            }
+        }
+    }
+
+    coro::Task<void> check_records(coro::AsyncGenerator<std::string> gen, size_t& count, size_t& ok) {
+        while( std::optional<std::string> r = co_await gen.next() ) {
+            ok += record(count) == *r ? 1 : 0;
+            ++count;
+        }
+    }
+
+    /** Yields 0 .. n-1, counting the produced elements. */
+    coro::AsyncGenerator<int> counted(int n, std::atomic<int>& produced) {
+        frame_guard g;
+        for(int i = 0; i < n; ++i) {
+            produced.store(i + 1);
+            co_yield i;
+        }
+    }
+
+    /**
+     * While processing element `i`, waits up to `timeout` for the producer to have produced element `i+1` concurrently.
+     * @return the number of elements overlapped this way
+     */
+    coro::Task<int> overlapped(coro::AsyncGenerator<int> gen, int n, std::atomic<int>& produced, std::chrono::milliseconds timeout) {
+        int count = 0;
+        while( std::optional<int> v = co_await gen.next() ) {
+            const int i = *v;
+            const auto t0 = std::chrono::steady_clock::now();
+            while( produced.load() < std::min(i + 2, n) && std::chrono::steady_clock::now() - t0 < timeout ) {
+                std::this_thread::yield();
+            }
+            count += produced.load() >= std::min(i + 2, n) ? 1 : 0;
+        }
+        co_return count;
+    }
+
+    bool wait_no_live_frames() {
+        const auto t0 = std::chrono::steady_clock::now();
+        while( 0 != frame_guard::live.load() && std::chrono::steady_clock::now() - t0 < 5s ) {
+            std::this_thread::sleep_for(1ms);
+        }
+        return 0 == frame_guard::live.load();
+    }
+}
+
+TEST_CASE( "Coroutine Async Generator Test 01", "[coroutine][async_generator]" ) {
+    using namespace test_env;
+
+    // producer awaits in between its yields
+    REQUIRE( 999 * 1000 / 2 == coro::sync_wait(sum_all(numbers(1000))) );
+    REQUIRE( 0 == coro::sync_wait(sum_all(numbers(0))) );
+    REQUIRE( 0 == frame_guard::live.load() );
+
+    // destroying the generator early destroys the suspended producer
+    REQUIRE( 0 + 1 + 2 == coro::sync_wait(sum_first(numbers(1000), 3)) );
+    REQUIRE( 0 == frame_guard::live.load() );
+
+    // exception rethrown after all prior elements
+    REQUIRE( -10 == coro::sync_wait(count_until_error(numbers(10, true))) );
+    REQUIRE( 0 == frame_guard::live.load() );
+
+    // next() after completion
+    {
+        auto twice = [](coro::AsyncGenerator<int> gen) -> coro::Task<bool> {
+            while( co_await gen.next() ) { }
+            co_return !( co_await gen.next() ).has_value();
+        };
+        REQUIRE( true == coro::sync_wait(twice(numbers(2))) );
+    }
+    // awaited tasks of the producer inherit the consumer's stop token, i.e. get cancelled by its deadline
+    {
+        coro::TimerService timers;
+        REQUIRE( false == coro::sync_wait(first(stop_possible())) );
+        REQUIRE( true == coro::sync_wait(timers.with_deadline(first(stop_possible()), 10s)) );
+        REQUIRE_THROWS_AS( coro::sync_wait(timers.with_deadline(first(sleepy(timers)), 20ms)), coro::deadline_exceeded );
+        REQUIRE( 0 == timers.size() );
+    }
+}
+
+TEST_CASE( "Coroutine Async Generator Test 02", "[coroutine][async_generator][reactor]" ) {
+    using namespace test_env;
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // records parsed as they stream in through a pipe, the writer suspends on a full pipe
+    const size_t n = 100'000;
+    coro::EpollReactor reactor;
+    int p[2];
+    REQUIRE( 0 == ::pipe(p) );
+    coro::AsyncFd rd(reactor, p[0]), wr(reactor, p[1]);
+    size_t count = 0, ok = 0;
+    reactor.spawn(check_records(records(rd), count, ok));
+    reactor.spawn(write_records(wr, n));
+    reactor.run();
+    REQUIRE( n == count );
+    REQUIRE( n == ok );
+}
+
+TEST_CASE( "Coroutine Async Generator Test 03", "[coroutine][async_generator][prefetch]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(2);
+
+    auto prefetched = [&](coro::AsyncGenerator<int> gen) {
+        gen.prefetch(sched);
+        return gen;
+    };
+
+    // same elements as w/o prefetching
+    REQUIRE( 999 * 1000 / 2 == coro::sync_wait(sum_all(prefetched(numbers(1000)))) );
+    REQUIRE( 0 == coro::sync_wait(sum_all(prefetched(numbers(0)))) );
+    REQUIRE( -10 == coro::sync_wait(count_until_error(prefetched(numbers(10, true)))) );
+    REQUIRE( true == wait_no_live_frames() );
+
+    // the next element is produced while the consumer processes the current one
+    {
+        std::atomic<int> produced = 0;
+        REQUIRE( 100 == coro::sync_wait(overlapped(prefetched(counted(100, produced)), 100, produced, 5000ms)) );
+        REQUIRE( true == wait_no_live_frames() );
+
+        // w/o prefetching the producer only runs within next()
+        produced = 0;
+        REQUIRE( 1 == coro::sync_wait(overlapped(counted(10, produced), 10, produced, 10ms)) ); // the last element only
+    }
+    // destroying the generator while prefetching, the producer destroys itself
+    for(int i = 0; i < 100; ++i) {
+        REQUIRE( 0 + 1 + 2 == coro::sync_wait(sum_first(prefetched(numbers(1000)), 3)) );
+    }
+    REQUIRE( true == wait_no_live_frames() );
+}
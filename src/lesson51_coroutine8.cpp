@@ -0,0 +1,243 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Coroutine structured concurrency via when_all and when_any
+//============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_timer.hpp"
+#include "cpp_basics/coro_when.hpp"
+
+using namespace std::chrono_literals;
+
+/**
+ * Lesson 5.1 Coroutine fan-out and fan-in of tasks on a coro::WorkStealingScheduler
+ * via coro::when_all() and coro::when_any(), w/o blocking any thread.
+ */
+namespace test_env {
+    typedef coro::TimerService::clock_type clock_type;
+
+    /** Records the threads tasks have been running on */
+    struct thread_log {
+        std::atomic<bool> off_caller = true;
+        std::thread::id caller = std::this_thread::get_id();
+
+        void check() {
+            if( caller == std::this_thread::get_id() ) {
+                off_caller = false;
+            }
+        }
+    };
+
+    coro::Task<int> square(int v, thread_log& log) {
+        log.check();
+        co_return v * v;
+    }
+
+    coro::Task<std::string> text(std::string s, thread_log& log) {
+        log.check();
+        co_return s;
+    }
+
+    coro::Task<void> touch(std::atomic<int>& count, thread_log& log) {
+        log.check();
+        count.fetch_add(1);
+        co_return;
+    }
+
+    coro::Task<int> fail(int v) {
+        throw std::runtime_error("fail " + std::to_string(v));
+        co_return v;
+    }
+
+    /** Sums the range by recursive fan-out until at most `grain` elements remain, i.e. nested groups. */
+    coro::Task<int64_t> parallel_sum(coro::WorkStealingScheduler& sched, std::span<const int> data, size_t grain) {
+        if( data.size() <= grain ) {
+            int64_t sum = 0;
+            for(int v : data) {
+                sum += v;
+            }
+            co_return sum;
+        }
+        const size_t half = data.size() / 2;
+        auto [l, r] = co_await coro::when_all(sched, parallel_sum(sched, data.first(half), grain),
+                                                     parallel_sum(sched, data.subspan(half), grain));
+        co_return l + r;
+    }
+
+    /** Sorts both halves in parallel down to `grain` elements, then merges them. */
+    coro::Task<void> parallel_sort(coro::WorkStealingScheduler& sched, std::span<int> data, size_t grain) {
+        if( data.size() <= grain ) {
+            std::sort(data.begin(), data.end());
+            co_return;
+        }
+        const size_t half = data.size() / 2;
+        co_await coro::when_all(sched, parallel_sort(sched, data.first(half), grain),
+                                       parallel_sort(sched, data.subspan(half), grain));
+        std::inplace_merge(data.begin(), data.begin() + half, data.end());
+    }
+
+    coro::Task<int> sleeper(coro::TimerService& timers, clock_type::duration d, int v) {
+        co_await timers.sleep_for(d);
+        co_return v;
+    }
+
+    coro::Task<int> fail_after(coro::TimerService& timers, clock_type::duration d) {
+        co_await timers.sleep_for(d);
+        throw std::runtime_error("fail_after");
+        co_return 0;
+    }
+
+    /** Ignores stop requests */
+    coro::Task<int> stubborn(clock_type::duration d, int v, std::atomic<int>& done) {
+        std::this_thread::sleep_for(d);
+        done.fetch_add(1);
+        co_return v;
+    }
+}
+
+TEST_CASE( "Coroutine When Test 01", "[coroutine][when_all]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(2);
+    thread_log log;
+
+    // heterogeneous results as tuple, in argument order
+    {
+        std::atomic<int> count = 0;
+        auto [a, b, c, d] = coro::sync_wait(coro::when_all(sched, square(3, log), text("x", log), touch(count, log), square(4, log)));
+        REQUIRE( 9 == a );
+        REQUIRE( "x" == b );
+        REQUIRE( std::monostate{} == c );
+        REQUIRE( 16 == d );
+        REQUIRE( 1 == count.load() );
+        REQUIRE( std::tuple<>{} == coro::sync_wait(coro::when_all(sched)) );
+    }
+    // homogeneous results as vector, in order
+    {
+        std::vector<coro::Task<int>> tasks;
+        for(int i = 0; i < 10'000; ++i) {
+            tasks.push_back(square(i, log));
+        }
+        const std::vector<int> res = coro::sync_wait(coro::when_all(sched, std::move(tasks)));
+        bool ordered = 10'000 == res.size();
+        for(size_t i = 0; ordered && i < res.size(); ++i) {
+            ordered = int(i * i) == res[i];
+        }
+        REQUIRE( true == ordered );
+        REQUIRE( true == coro::sync_wait(coro::when_all(sched, std::vector<coro::Task<int>>())).empty() );
+
+        std::atomic<int> count = 0;
+        std::vector<coro::Task<void>> voids;
+        for(int i = 0; i < 1000; ++i) {
+            voids.push_back(touch(count, log));
+        }
+        coro::sync_wait(coro::when_all(sched, std::move(voids)));
+        REQUIRE( 1000 == count.load() );
+    }
+    REQUIRE( true == log.off_caller.load() );
+
+    // all tasks complete, the first exception in order is rethrown
+    {
+        std::atomic<int> count = 0;
+        std::vector<coro::Task<void>> tasks;
+        auto failing = [](int v) -> coro::Task<void> { co_await fail(v); };
+        tasks.push_back(touch(count, log));
+        tasks.push_back(failing(1));
+        tasks.push_back(failing(2));
+        tasks.push_back(touch(count, log));
+        std::string what;
+        try {
+            coro::sync_wait(coro::when_all(sched, std::move(tasks)));
+        } catch (const std::runtime_error& e) {
+            what = e.what();
+        }
+        REQUIRE( "fail 1" == what );
+        REQUIRE( 2 == count.load() );
+        REQUIRE_THROWS_AS( coro::sync_wait(coro::when_all(sched, square(1, log), fail(2))), std::runtime_error );
+    }
+}
+
+TEST_CASE( "Coroutine When Test 02", "[coroutine][when_all][nested]" ) {
+    using namespace test_env;
+
+    // nested groups on a single worker never block it, each awaiting group suspends
+    for(size_t workers : { 1, 2 }) {
+        coro::WorkStealingScheduler sched(workers);
+        std::vector<int> data(1'000'000);
+        std::mt19937 rng(42);
+        for(int& v : data) {
+            v = int(rng() % 1000);
+        }
+        int64_t expected = 0;
+        for(int v : data) {
+            expected += v;
+        }
+        REQUIRE( expected == coro::sync_wait(parallel_sum(sched, data, 1000)) );
+
+        coro::sync_wait(parallel_sort(sched, data, 10'000));
+        REQUIRE( true == std::is_sorted(data.begin(), data.end()) );
+    }
+}
+
+TEST_CASE( "Coroutine When Test 03", "[coroutine][when_any]" ) {
+    using namespace test_env;
+    coro::WorkStealingScheduler sched(2);
+    coro::TimerService timers(&sched);
+
+    // first completed wins, the others are cancelled
+    {
+        std::vector<coro::Task<int>> tasks;
+        tasks.push_back(sleeper(timers, 10s, 0));
+        tasks.push_back(sleeper(timers, 5ms, 1));
+        tasks.push_back(sleeper(timers, 10s, 2));
+        const clock_type::time_point t0 = clock_type::now();
+        const coro::when_any_result<int> r = coro::sync_wait(coro::when_any(sched, std::move(tasks)));
+        REQUIRE( clock_type::now() - t0 < 5s );
+        REQUIRE( 1 == r.index );
+        REQUIRE( 1 == r.value );
+        REQUIRE( 0 == timers.size() );
+    }
+    // the first's exception is rethrown
+    {
+        std::vector<coro::Task<int>> tasks;
+        tasks.push_back(sleeper(timers, 10s, 0));
+        tasks.push_back(fail_after(timers, 5ms));
+        REQUIRE_THROWS_AS( coro::sync_wait(coro::when_any(sched, std::move(tasks))), std::runtime_error );
+    }
+    // completes only after all tasks, even if ignoring the stop request
+    {
+        std::atomic<int> done = 0;
+        std::vector<coro::Task<int>> tasks;
+        tasks.push_back(stubborn(20ms, 0, done));
+        tasks.push_back(sleeper(timers, 1ms, 1));
+        const coro::when_any_result<int> r = coro::sync_wait(coro::when_any(sched, std::move(tasks)));
+        REQUIRE( 1 == done.load() );
+        REQUIRE( size_t(r.value) == r.index );
+    }
+    // the awaiting coroutine's cancellation reaches all tasks
+    {
+        std::vector<coro::Task<int>> tasks;
+        tasks.push_back(sleeper(timers, 10s, 0));
+        tasks.push_back(sleeper(timers, 10s, 1));
+        REQUIRE_THROWS_AS( coro::sync_wait(timers.with_deadline(coro::when_any(sched, std::move(tasks)), 20ms)), coro::deadline_exceeded );
+        REQUIRE( 0 == timers.size() );
+    }
+    REQUIRE_THROWS_AS( coro::sync_wait(coro::when_any(sched, std::vector<coro::Task<int>>())), std::invalid_argument );
+}
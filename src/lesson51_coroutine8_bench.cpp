@@ -0,0 +1,150 @@
+//============================================================================
+// Author      : Sven Göthel
+// Version     : 0.1
+// Copyright   : MIT
+// Description : C++ Lesson 5.1 Benchmarking coroutine fan-out and fan-in via when_all
+//============================================================================
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <jau/test/catch2_ext.hpp>
+
+#include "cpp_basics/bench_csv.hpp"
+#include "cpp_basics/coro_task.hpp"
+#include "cpp_basics/coro_scheduler.hpp"
+#include "cpp_basics/coro_when.hpp"
+
+/**
+ * Lesson 5.1 Benchmark of fan-out and fan-in of `n` child tasks via coro::when_all(),
+ * scaling the number of children and of scheduler workers.
+ *
+ * Default CI unit test run (no arguments) only covers small sizes.
+ * Run with `--perf_analysis` for the full range of sizes.
+ *
+ * Each benchmark is named `<variant> workers <w> <n>` and runs `n` trivial children on `w` workers,
+ * i.e. the bench-csv ns_per_element column reports ns per child, see cpp_basics::BenchCSVListener.
+ * A final children/sec summary is emitted via WARN.
+ *
+ * Variants
+ * - `when_all`: one group of `n` tasks awaited via a single countdown
+ * - `when_all_tree`: binary tree of nested groups down to single tasks, i.e. `n - 1` groups
+ * - `spawn_join`: `n` tasks spawned individually and their JoinHandles awaited one by one
+ * - `thread_join`: `n` std::thread started and joined, for small `n` only
+ */
+namespace bench_env {
+    coro::Task<uint64_t> child(uint64_t v) {
+        co_return v;
+    }
+
+    coro::Task<uint64_t> fan_out(coro::WorkStealingScheduler& sched, uint64_t n) {
+        std::vector<coro::Task<uint64_t>> tasks;
+        tasks.reserve(n);
+        for(uint64_t i = 0; i < n; ++i) {
+            tasks.push_back(child(i));
+        }
+        uint64_t sum = 0;
+        for(uint64_t v : co_await coro::when_all(sched, std::move(tasks))) {
+            sum += v;
+        }
+        co_return sum;
+    }
+
+    /** Sums [lo, hi) via nested groups of two. */
+    coro::Task<uint64_t> tree(coro::WorkStealingScheduler& sched, uint64_t lo, uint64_t hi) {
+        if( hi - lo <= 1 ) {
+            co_return lo;
+        }
+        const uint64_t mid = lo + ( hi - lo ) / 2;
+        auto [l, r] = co_await coro::when_all(sched, tree(sched, lo, mid), tree(sched, mid, hi));
+        co_return l + r;
+    }
+
+    coro::Task<uint64_t> spawn_join(coro::WorkStealingScheduler& sched, uint64_t n) {
+        std::vector<coro::JoinHandle<uint64_t>> hs;
+        hs.reserve(n);
+        for(uint64_t i = 0; i < n; ++i) {
+            hs.push_back(sched.spawn(child(i)));
+        }
+        uint64_t sum = 0;
+        for(coro::JoinHandle<uint64_t>& h : hs) {
+            sum += co_await h;
+        }
+        co_return sum;
+    }
+
+    uint64_t thread_join(uint64_t n) {
+        std::vector<uint64_t> res(n);
+        std::vector<std::thread> ts;
+        ts.reserve(n);
+        for(uint64_t i = 0; i < n; ++i) {
+            ts.emplace_back([&res, i]() { res[i] = i; });
+        }
+        uint64_t sum = 0;
+        for(uint64_t i = 0; i < n; ++i) {
+            ts[i].join();
+            sum += res[i];
+        }
+        return sum;
+    }
+
+    constexpr uint64_t thread_max = 1000;
+
+    std::vector<uint64_t> child_counts() {
+        if( catch_perf_analysis ) {
+            return { 10, 1000, 100'000 };
+        }
+        return { 10, 1000 };
+    }
+}
+
+TEST_CASE( "Coroutine When Benchmark 01", "[coroutine][when_all][benchmark]" ) {
+    using namespace bench_env;
+
+    for(size_t workers : { 1, 2, 4 }) {
+        coro::WorkStealingScheduler sched(workers);
+        const std::string sw = std::to_string(workers);
+        for(uint64_t n : child_counts()) {
+            const std::string sn = std::to_string(n);
+            const uint64_t expected = n * ( n - 1 ) / 2;
+            REQUIRE( expected == coro::sync_wait(fan_out(sched, n)) );
+            REQUIRE( expected == coro::sync_wait(tree(sched, 0, n)) );
+            REQUIRE( expected == coro::sync_wait(spawn_join(sched, n)) );
+
+            BENCHMARK("when_all workers "+sw+" "+sn) {
+                return coro::sync_wait(fan_out(sched, n));
+            };
+            BENCHMARK("when_all_tree workers "+sw+" "+sn) {
+                return coro::sync_wait(tree(sched, 0, n));
+            };
+            BENCHMARK("spawn_join workers "+sw+" "+sn) {
+                return coro::sync_wait(spawn_join(sched, n));
+            };
+            if( 1 == workers && n <= thread_max ) {
+                BENCHMARK("thread_join workers 0 "+sn) {
+                    return thread_join(n);
+                };
+            }
+        }
+    }
+
+    // children/sec summary of the largest group
+    {
+        const uint64_t n = child_counts().back();
+        coro::WorkStealingScheduler sched(2);
+        typedef std::chrono::steady_clock clock_type;
+        const clock_type::time_point t0 = clock_type::now();
+        const uint64_t sum = coro::sync_wait(fan_out(sched, n));
+        const double secs = std::chrono::duration<double>(clock_type::now() - t0).count();
+        REQUIRE( n * ( n - 1 ) / 2 == sum );
+
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "when_all of %llu children on 2 workers: %.1f ns/child, %.0f children/sec\n",
+                      (unsigned long long)n, secs * 1e9 / double(n), double(n) / secs);
+        WARN(buf);
+    }
+}